@@ -0,0 +1,55 @@
+#ifndef __CUBE_GOAL_H__
+#define __CUBE_GOAL_H__
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "frontier_pool.h"
+#include "rubiks_cube.h"
+
+/**
+ * @brief Goal requiring the given facelets (face * 9 + index) to show their solved colors
+ */
+CubeGoal makeFaceletGoal(const std::vector<int>& facelets);
+
+// Edges around a face (the "cross"), a 2x2x2 block at the corner of three adjacent faces, the first two layers
+// opposite a face, and a whole face showing one color (last-layer orientation).
+CubeGoal crossGoal(int face);
+CubeGoal blockGoal(int faceA, int faceB, int faceC);
+CubeGoal firstTwoLayersGoal(int face);
+CubeGoal orientLastLayerGoal(int face);
+
+/**
+ * @brief Per-goal pruning table
+ * States are projected onto the stickers the goal pins down (every other facelet becomes DONT_CARE_COLOR) and the
+ * table holds the exact distance of every projection reachable within maxDepth moves of the solved projection.
+ * Unseen projections are at least maxDepth + 1 away. The bound is admissible when the goal pins whole cubies or
+ * whole colors, which is the case for all the goal helpers above.
+ */
+class GoalPruningTable {
+private:
+    CubeGoal target;
+    int depthLimit;
+    bool keep[256][8];
+    std::unordered_map<RubiksCube, uint8_t, RubiksCubeHash, std::equal_to<RubiksCube>,
+                       PoolAllocator<std::pair<const RubiksCube, uint8_t>>>
+        distance;
+public:
+    GoalPruningTable(const CubeGoal& goal, int maxDepth);
+
+    RubiksCube project(const RubiksCube& cube) const;
+    int lowerBound(const RubiksCube& cube) const;
+
+    const CubeGoal& goal() const { return target; }
+    int maxDepth() const { return depthLimit; }
+    size_t size() const { return distance.size(); }
+};
+
+/**
+ * @brief IDA* search for the shortest move sequence that takes cube to a state satisfying the table's goal
+ * Returns false if no solution of at most maxDepth moves exists.
+ */
+bool solveGoal(const RubiksCube& cube, const GoalPruningTable& table, int maxDepth, std::vector<MoveType>& solution);
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef __CUBE_SYMMETRY_H__
+#define __CUBE_SYMMETRY_H__
+
+#include <vector>
+
+#include "rubiks_cube.h"
+
+#define NUM_CUBE_SYMMETRIES 24
+
+/**
+ * @brief Whole-cube rotation, used to relate states that are the same up to how the cube is held
+ * Applying a symmetry moves every facelet p to perm[p] and recolors it through colorMap so the centers keep their
+ * standard colors. Moves map across with moveMap: applySymmetry(c.move(m)) == applySymmetry(c).move(moveMap[m]).
+ * Mirror images are left out since they turn clockwise moves into counter-clockwise ones.
+ */
+struct CubeSymmetry {
+    int perm[NUM_FACELETS];
+    uint8_t colorMap[NUM_FACES];
+    MoveType moveMap[6];
+    MoveType inverseMoveMap[6];
+};
+
+// Index 0 is the identity
+const CubeSymmetry* cubeSymmetries();
+
+RubiksCube applySymmetry(const RubiksCube& cube, const CubeSymmetry& symmetry);
+
+/**
+ * @brief State reached by undoing cube's scramble on a solved cube
+ * If a sequence takes the solved cube to cube, its reverse (with each move inverted) takes it to invertCube(cube).
+ */
+RubiksCube invertCube(const RubiksCube& cube);
+
+/**
+ * @brief Inverse of a move sequence in our clockwise-only metric: reversed, each move turned three times
+ */
+std::vector<MoveType> invertMoves(const std::vector<MoveType>& moves);
+
+struct CanonicalForm {
+    RubiksCube cube;
+    int symmetry;
+    bool inverted;
+};
+
+/**
+ * @brief Smallest representative of cube over all symmetries (and over its inverse if useInverse is set)
+ */
+CanonicalForm canonicalize(const RubiksCube& cube, bool useInverse);
+
+/**
+ * @brief Turns a solution of the cube that was canonicalized into a solution of form.cube
+ */
+std::vector<MoveType> canonicalSolution(const std::vector<MoveType>& solution, const CanonicalForm& form);
+
+/**
+ * @brief Turns a solution of form.cube into a solution of the cube it was canonicalized from
+ */
+std::vector<MoveType> mapSolution(const std::vector<MoveType>& canonicalSolution, const CanonicalForm& form);
+
+#endif
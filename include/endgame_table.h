@@ -0,0 +1,97 @@
+#ifndef __ENDGAME_TABLE_H__
+#define __ENDGAME_TABLE_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "rubiks_cube.h"
+
+/**
+ * @brief Every state within a fixed number of moves of SOLVED_CUBE, with its distance and the move towards solved
+ * Stored as an open-addressing hash table of 24-byte entries: the cube's faces only use their top 27 bits, so the
+ * distance and next move ride along in the spare low bits. The same layout is used on disk, so a saved table can be
+ * mmap-ed straight back in.
+ */
+class EndgameTable {
+private:
+    struct Entry {
+        uint32_t words[6];
+    };
+
+    std::vector<Entry> storage;
+    const Entry* entries;
+    uint64_t capacity;
+    uint64_t count;
+    int maxDepth;
+
+    void* mapping;
+    size_t mappingBytes;
+
+    EndgameTable();
+    const Entry* find(const RubiksCube& cube, size_t slot) const;
+    bool insert(const RubiksCube& cube, int distance, MoveType nextMove);
+    void grow();
+public:
+    explicit EndgameTable(int depth);
+    ~EndgameTable();
+
+    EndgameTable(const EndgameTable&) = delete;
+    EndgameTable& operator=(const EndgameTable&) = delete;
+
+    /**
+     * @brief Write the table to path, or map a saved table read-only. load() returns nullptr on failure.
+     * load() checks the file with fromImage(), so it reads the whole mapping once: loading costs a pass over the file
+     * and faults in all of its pages, rather than paging the table in as probes touch it.
+     */
+    bool save(const char* path) const;
+    static std::unique_ptr<EndgameTable> load(const char* path);
+
+    /**
+     * @brief The saved file's bytes, for placing the table in memory of our choosing (see NodeLocalTable)
+     * fromImage() returns a view that doesn't own the image, or nullptr if it isn't a valid table; it reads every entry
+     * to check that.
+     */
+    size_t imageBytes() const;
+    void writeImage(void* image) const;
+    static std::unique_ptr<EndgameTable> fromImage(const void* image, size_t bytes);
+
+    /**
+     * @brief Look cube up; on a hit, distance is its exact distance to solved and nextMove starts a shortest path
+     */
+    bool probe(const RubiksCube& cube, int& distance, MoveType& nextMove) const;
+
+    /**
+     * @brief Start loading the slot cube hashes to, so several probes can overlap their cache misses
+     */
+    void prefetch(const RubiksCube& cube) const { prefetchSlot(slotOf(cube)); }
+
+    /**
+     * @brief The same lookups split into stages for expandNode(): find the home slot, prefetch it, then read it
+     * lowerBound() is the exact distance for stored cubes and depth() + 1 for the rest.
+     */
+    size_t slotOf(const RubiksCube& cube) const { return slotOfHash(cube.hash()); }
+    size_t slotOfHash(uint64_t hash) const { return hash & (capacity - 1); }
+    void prefetchSlot(size_t slot) const { __builtin_prefetch(&entries[slot]); }
+    int lowerBound(const RubiksCube& cube, size_t slot) const;
+
+    /**
+     * @brief Which of up to 32 cubes are stored, for the lockstep search: faces[f * stride + i] is face f of cube i and
+     * slots[i] its home slot. Only the cubes in lanes are looked up. Every home slot is checked without branching before
+     * any collision chain is followed, so the lookups don't serialize on each other's mispredictions. Returns the
+     * mask of cubes found.
+     */
+    uint32_t findLanes(const uint32_t* faces, int stride, const size_t* slots, uint32_t lanes) const;
+
+    /**
+     * @brief Follow next moves from cube to solved, appending them to solution. Returns false, leaving solution as it
+     * was, if cube isn't stored or the chain of next moves is broken.
+     */
+    bool appendSolution(const RubiksCube& cube, std::vector<MoveType>& solution) const;
+
+    int depth() const { return maxDepth; }
+    size_t size() const { return count; }
+};
+
+#endif
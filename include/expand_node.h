@@ -0,0 +1,71 @@
+#ifndef __EXPAND_NODE_H__
+#define __EXPAND_NODE_H__
+
+#include <cstddef>
+
+#include "rubiks_cube.h"
+
+#define MAX_CHILDREN 6
+
+struct ChildNode {
+    RubiksCube cube;
+    MoveType move;
+    int run;       // copies of move at the end of the path, for isRedundantMove()
+    int estimate;  // the table's lower bound on the child's distance to solved
+};
+
+/**
+ * @brief Generate the children of cube reached by a move that isn't redundant after a run of `run` copies of prev
+ * Returns the number of children written.
+ */
+inline int generateChildren(const RubiksCube& cube, MoveType prev, int run, ChildNode children[MAX_CHILDREN])
+{
+    int n = 0;
+    for (auto m : availableMoves) {
+        if (isRedundantMove(prev, run, m)) continue;
+        children[n].cube = cube;
+        children[n].cube.move(m);
+        children[n].move = m;
+        children[n].run = m == prev ? run + 1 : 1;
+        ++n;
+    }
+    return n;
+}
+
+/**
+ * @brief Expand a search node with software-pipelined table lookups
+ * All children are generated first, then their table slots are computed and prefetched together, and only then are
+ * the entries read, so the cache misses of the lookups overlap instead of being taken one after another. Children
+ * whose estimate exceeds budget are dropped and the rest are ordered by estimate, most promising first.
+ *
+ * Table provides size_t slotOf(const RubiksCube&), void prefetchSlot(size_t) and
+ * int lowerBound(const RubiksCube&, size_t slot); EndgameTable is one. Returns the number of children kept, and the
+ * number looked up in *generated if it isn't null.
+ */
+template <typename Table>
+int expandNode(const RubiksCube& cube, MoveType prev, int run, const Table& table, int budget,
+               ChildNode children[MAX_CHILDREN], int* generated = nullptr)
+{
+    int n = generateChildren(cube, prev, run, children);
+    if (generated) *generated = n;
+
+    size_t slots[MAX_CHILDREN];
+    for (int i = 0; i < n; ++i) slots[i] = table.slotOf(children[i].cube);
+    for (int i = 0; i < n; ++i) table.prefetchSlot(slots[i]);
+
+    int kept = 0;
+    for (int i = 0; i < n; ++i) {
+        int estimate = table.lowerBound(children[i].cube, slots[i]);
+        if (estimate > budget) continue;
+
+        // Insertion sort; stable, so ties keep move order
+        ChildNode child = children[i];
+        child.estimate = estimate;
+        int j = kept++;
+        for (; j > 0 && children[j - 1].estimate > estimate; --j) children[j] = children[j - 1];
+        children[j] = child;
+    }
+    return kept;
+}
+
+#endif
@@ -0,0 +1,166 @@
+#ifndef __FRONTIER_POOL_H__
+#define __FRONTIER_POOL_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include "rubiks_cube.h"
+
+#define POOL_CHUNK_BYTES (64 * 1024)
+#define CUBES_PER_CHUNK (POOL_CHUNK_BYTES / sizeof(RubiksCube))
+
+/**
+ * @brief Recycling pool of fixed-size, cache-line aligned chunks
+ * Released chunks go on a free list and are handed out again, so once a search has reached its peak working set it
+ * stops calling the system allocator. Memory goes back to the system only when the pool is destroyed. Not thread-safe:
+ * use one pool per thread. ChunkPool::local() lives as long as its thread, so it suits callers that fill frontiers over
+ * and over; a one-off build such as a table constructor should own a pool, which frees its chunks when the build ends.
+ */
+class ChunkPool {
+private:
+    std::vector<void*> chunks;
+    std::vector<void*> freeChunks;
+public:
+    ChunkPool() {}
+    ~ChunkPool();
+
+    ChunkPool(const ChunkPool&) = delete;
+    ChunkPool& operator=(const ChunkPool&) = delete;
+
+    void* acquire();
+    void release(void* chunk);
+
+    size_t allocated() const { return chunks.size(); }
+    size_t available() const { return freeChunks.size(); }
+
+    // The calling thread's pool
+    static ChunkPool& local();
+};
+
+/**
+ * @brief Append-only sequence of packed cube states stored in pool chunks
+ * Meant for BFS levels and work queues: fill one buffer while streaming through another, then swap and clear. Clearing
+ * hands the chunks back to the pool for the next level instead of freeing them. Buffers must be filled and destroyed on
+ * the thread that owns their pool.
+ */
+class FrontierBuffer {
+private:
+    ChunkPool* pool;
+    std::vector<RubiksCube*> chunks;
+    RubiksCube* tail;
+    RubiksCube* tailEnd;
+    size_t count;
+
+    void addChunk();
+public:
+    explicit FrontierBuffer(ChunkPool& chunkPool = ChunkPool::local());
+    ~FrontierBuffer() { clear(); }
+
+    FrontierBuffer(const FrontierBuffer&) = delete;
+    FrontierBuffer& operator=(const FrontierBuffer&) = delete;
+
+    void push_back(const RubiksCube& cube)
+    {
+        if (tail == tailEnd) addChunk();
+        new (tail++) RubiksCube(cube);
+        ++count;
+    }
+
+    void clear();
+    void swap(FrontierBuffer& other);
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    // Contiguous runs of states, in insertion order
+    size_t numChunks() const { return chunks.size(); }
+    const RubiksCube* chunk(size_t i) const { return chunks[i]; }
+    size_t chunkSize(size_t i) const { return i + 1 < chunks.size() ? CUBES_PER_CHUNK : count - i * CUBES_PER_CHUNK; }
+
+    template <typename Visit>
+    void forEach(Visit visit) const
+    {
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            const RubiksCube* states = chunks[i];
+            for (size_t j = 0, n = chunkSize(i); j < n; ++j) visit(states[j]);
+        }
+    }
+};
+
+/**
+ * @brief Size-class free lists for small blocks, carved out of large slabs
+ * Backs PoolAllocator so node-based containers (unordered_map/set) don't hit the system allocator per node.
+ */
+class PoolArena {
+private:
+    static const size_t BLOCK_ALIGN = 16;
+    static const size_t NUM_SIZE_CLASSES = 16;
+
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    FreeBlock* freeLists[NUM_SIZE_CLASSES];
+    char* bump;
+    char* bumpEnd;
+    std::vector<void*> slabs;
+public:
+    static const size_t MAX_BLOCK_BYTES = BLOCK_ALIGN * NUM_SIZE_CLASSES;
+
+    PoolArena();
+    ~PoolArena();
+
+    PoolArena(const PoolArena&) = delete;
+    PoolArena& operator=(const PoolArena&) = delete;
+
+    void* allocate(size_t bytes);
+    void deallocate(void* block, size_t bytes);
+
+    size_t slabCount() const { return slabs.size(); }
+};
+
+/**
+ * @brief Standard allocator drawing single small objects from a PoolArena
+ * Copies (including rebinds) share the arena, so a container and its internals use one arena; arrays and large objects
+ * (e.g. hash buckets) go to operator new. Like the container it serves, it is not thread-safe.
+ */
+template <typename T>
+class PoolAllocator {
+public:
+    typedef T value_type;
+
+    std::shared_ptr<PoolArena> arena;
+
+    PoolAllocator() : arena(std::make_shared<PoolArena>()) {}
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>& other) : arena(other.arena)
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+        if (n == 1 && sizeof(T) <= PoolArena::MAX_BLOCK_BYTES && alignof(T) <= 16) {
+            return static_cast<T*>(arena->allocate(sizeof(T)));
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n)
+    {
+        if (n == 1 && sizeof(T) <= PoolArena::MAX_BLOCK_BYTES && alignof(T) <= 16) {
+            arena->deallocate(p, sizeof(T));
+        } else {
+            ::operator delete(p);
+        }
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>& other) const { return arena == other.arena; }
+    template <typename U>
+    bool operator!=(const PoolAllocator<U>& other) const { return arena != other.arena; }
+};
+
+#endif
@@ -0,0 +1,253 @@
+#ifndef __MOVE_KERNELS_H__
+#define __MOVE_KERNELS_H__
+
+#include <cstdint>
+
+#include "rubiks_cube.h"
+
+// The move kernels are written against a generic Word so the same bit manipulation runs on a single uint32_t face or
+// on a SIMD vector holding the same face of several cubes (see solveCubeBatch).
+
+#define BITS_PER_COLOR 3
+
+// Masking helpers for manipulating cube face bits
+const uint32_t MASK_N_BITS = 0xE;
+const uint32_t MASK_N_BITS_IDX_0 = MASK_N_BITS << (31 - BITS_PER_COLOR);
+const uint32_t MASK_N_BITS_IDX_1 = MASK_N_BITS_IDX_0 >> BITS_PER_COLOR;
+const uint32_t MASK_N_BITS_IDX_2 = MASK_N_BITS_IDX_1 >> BITS_PER_COLOR;
+const uint32_t MASK_N_BITS_IDX_3 = MASK_N_BITS_IDX_2 >> BITS_PER_COLOR;
+const uint32_t MASK_N_BITS_IDX_4 = MASK_N_BITS_IDX_3 >> BITS_PER_COLOR;
+const uint32_t MASK_N_BITS_IDX_5 = MASK_N_BITS_IDX_4 >> BITS_PER_COLOR;
+const uint32_t MASK_N_BITS_IDX_6 = MASK_N_BITS_IDX_5 >> BITS_PER_COLOR;
+const uint32_t MASK_N_BITS_IDX_7 = MASK_N_BITS_IDX_6 >> BITS_PER_COLOR;
+const uint32_t MASK_N_BITS_IDX_8 = MASK_N_BITS_IDX_7 >> BITS_PER_COLOR;
+
+const uint32_t TOP_MASK = 0xFF800000;
+const uint32_t NOT_TOP_MASK = ~TOP_MASK;
+
+const uint32_t BOTTOM_MASK = 0x3FE0;
+const uint32_t NOT_BOTTOM_MASK = ~BOTTOM_MASK;
+
+const uint32_t RIGHT_MASK = 0x381C0E0;
+const uint32_t NOT_RIGHT_MASK = ~RIGHT_MASK;
+
+const uint32_t LEFT_MASK = 0xE0703800;
+const uint32_t NOT_LEFT_MASK = ~LEFT_MASK;
+
+// Vector words are passed by reference: passing them by value would tie the kernels to the vector ABI of whichever
+// instruction set they are compiled for
+template <typename Word>
+inline void rotateFaceClockwise(const Word& faceData, Word& rotatedFaceData)
+{
+    rotatedFaceData = ((faceData << (6 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_0) |
+                      ((faceData << (2 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_1) |
+                      ((faceData >> (2 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_2) |
+                      ((faceData << (4 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_3) |
+                      (faceData & MASK_N_BITS_IDX_4) |
+                      ((faceData >> (4 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_5) |
+                      ((faceData << (2 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_6) |
+                      ((faceData >> (2 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_7) |
+                      ((faceData >> (6 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_8);
+
+    /*
+    123
+    456
+    789
+
+    741
+    852
+    963
+    */
+}
+
+/**
+ * @brief Apply a clockwise quarter turn to the six faces in data
+ */
+template <typename Word>
+inline void applyMove(Word* data, MoveType type)
+{
+    switch (type) {
+        case U1: {
+            // Rotate top face clockwise by 90 degrees
+            Word rotatedTop;
+            rotateFaceClockwise<Word>(data[0], rotatedTop);
+
+            Word top1 = data[1] & TOP_MASK;
+            Word top2 = data[2] & TOP_MASK;
+            Word top3 = data[3] & TOP_MASK;
+            Word top4 = data[4] & TOP_MASK;
+
+            data[1] = top2 | (data[1] & NOT_TOP_MASK);
+            data[2] = top3 | (data[2] & NOT_TOP_MASK);
+            data[3] = top4 | (data[3] & NOT_TOP_MASK);
+            data[4] = top1 | (data[4] & NOT_TOP_MASK);
+            data[0] = rotatedTop;
+
+            break;
+        }
+        case D1: {
+            // Rotate bottom face clockwise by 90 degrees
+            Word rotatedBottom;
+            rotateFaceClockwise<Word>(data[5], rotatedBottom);
+
+            Word bottom1 = data[1] & BOTTOM_MASK;
+            Word bottom2 = data[2] & BOTTOM_MASK;
+            Word bottom3 = data[3] & BOTTOM_MASK;
+            Word bottom4 = data[4] & BOTTOM_MASK;
+
+            data[1] = bottom4 | (data[1] & NOT_BOTTOM_MASK);
+            data[2] = bottom1 | (data[2] & NOT_BOTTOM_MASK);
+            data[3] = bottom2 | (data[3] & NOT_BOTTOM_MASK);
+            data[4] = bottom3 | (data[4] & NOT_BOTTOM_MASK);
+            data[5] = rotatedBottom;
+
+            break;
+        }
+        case R1: {
+            // Rotate right face clockwise by 90 degrees
+            Word rotatedRight;
+            rotateFaceClockwise<Word>(data[3], rotatedRight);
+
+            Word right0 = data[0] & RIGHT_MASK;
+            Word right2 = data[2] & RIGHT_MASK;
+            Word left4 = data[4] & LEFT_MASK;
+            Word right5 = data[5] & RIGHT_MASK;
+
+            // The back face is stored as seen from behind, so columns moving through it are reversed
+            Word newRight5 = ((left4 << (4 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_2) |
+                             ((left4 >> (2 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_5) |
+                             ((left4 >> (8 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_8);
+
+            Word newLeft4 = ((right0 << (8 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_0) |
+                            ((right0 << (2 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_3) |
+                            ((right0 >> (4 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_6);
+
+            data[0] = right2 | (data[0] & NOT_RIGHT_MASK);
+            data[2] = right5 | (data[2] & NOT_RIGHT_MASK);
+            data[5] = newRight5 | (data[5] & NOT_RIGHT_MASK);
+            data[4] = newLeft4 | (data[4] & NOT_LEFT_MASK);
+            data[3] = rotatedRight;
+
+            break;
+        }
+        case L1: {
+            // Rotate left face clockwise by 90 degrees
+            Word rotatedLeft;
+            rotateFaceClockwise<Word>(data[1], rotatedLeft);
+
+            Word left0 = data[0] & LEFT_MASK;
+            Word left2 = data[2] & LEFT_MASK;
+            Word right4 = data[4] & RIGHT_MASK;
+            Word left5 = data[5] & LEFT_MASK;
+
+            // The back face is stored as seen from behind, so columns moving through it are reversed
+            Word newLeft0 = ((right4 << (8 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_0) |
+                            ((right4 << (2 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_3) |
+                            ((right4 >> (4 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_6);
+
+            Word newRight4 = ((left5 << (4 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_2) |
+                             ((left5 >> (2 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_5) |
+                             ((left5 >> (8 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_8);
+
+            data[0] = newLeft0 | (data[0] & NOT_LEFT_MASK);
+            data[2] = left0 | (data[2] & NOT_LEFT_MASK);
+            data[5] = left2 | (data[5] & NOT_LEFT_MASK);
+            data[4] = newRight4 | (data[4] & NOT_RIGHT_MASK);
+            data[1] = rotatedLeft;
+
+            break;
+        }
+        case F1: {
+            // Rotate front face clockwise by 90 degrees
+            Word rotatedFront;
+            rotateFaceClockwise<Word>(data[2], rotatedFront);
+
+            Word bottom0 = data[0] & BOTTOM_MASK;
+            Word left3 = data[3] & LEFT_MASK;
+            Word top5 = data[5] & TOP_MASK;
+            Word right1 = data[1] & RIGHT_MASK;
+
+            Word newBottom0 = ((right1 << (2 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_6) |
+                              ((right1 >> (2 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_7) |
+                              ((right1 >> (6 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_8);
+
+            Word newLeft3 = ((bottom0 << (6 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_0) |
+                            ((bottom0 << (4 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_3) |
+                            ((bottom0 << (2 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_6);
+
+            Word newTop5 = ((left3 << (6 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_0) |
+                           ((left3 << (2 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_1) |
+                           ((left3 >> (2 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_2);
+
+            Word newRight1 = ((top5 >> (2 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_2) |
+                             ((top5 >> (4 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_5) |
+                             ((top5 >> (6 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_8);
+
+            data[0] = newBottom0 | (data[0] & NOT_BOTTOM_MASK);
+            data[3] = newLeft3 | (data[3] & NOT_LEFT_MASK);
+            data[5] = newTop5 | (data[5] & NOT_TOP_MASK);
+            data[1] = newRight1 | (data[1] & NOT_RIGHT_MASK);
+            data[2] = rotatedFront;
+
+            break;
+        }
+        case B1: {
+            // Rotate back face clockwise by 90 degrees
+            Word rotatedBack;
+            rotateFaceClockwise<Word>(data[4], rotatedBack);
+
+            Word top0 = data[0] & TOP_MASK;
+            Word right3 = data[3] & RIGHT_MASK;
+            Word bottom5 = data[5] & BOTTOM_MASK;
+            Word left1 = data[1] & LEFT_MASK;
+
+            Word newTop0 = ((right3 << (2 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_0) |
+                           ((right3 << (4 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_1) |
+                           ((right3 << (6 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_2);
+
+            Word newRight3 = ((bottom5 << (6 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_2) |
+                             ((bottom5 << (2 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_5) |
+                             ((bottom5 >> (2 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_8);
+
+            Word newBottom5 = ((left1 >> (6 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_6) |
+                              ((left1 >> (4 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_7) |
+                              ((left1 >> (2 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_8);
+
+            Word newLeft1 = ((top0 << (2 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_0) |
+                            ((top0 >> (2 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_3) |
+                            ((top0 >> (6 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_6);
+
+            data[0] = newTop0 | (data[0] & NOT_TOP_MASK);
+            data[3] = newRight3 | (data[3] & NOT_RIGHT_MASK);
+            data[5] = newBottom5 | (data[5] & NOT_BOTTOM_MASK);
+            data[1] = newLeft1 | (data[1] & NOT_LEFT_MASK);
+            data[4] = rotatedBack;
+
+            break;
+        }
+    }
+}
+
+/**
+ * @brief RubiksCube::hash() of the six faces in data, into a Wide word with 64-bit lanes for each lane of Word
+ */
+template <typename Word, typename Wide>
+inline void hashFaces(const Word* data, Wide& hash)
+{
+    Wide faces[6];
+    for (int i = 0; i < 6; ++i) {
+        if constexpr (sizeof(Word) == sizeof(uint32_t)) {
+            faces[i] = data[i];
+        } else {
+            faces[i] = __builtin_convertvector(data[i], Wide);
+        }
+    }
+
+    // Each face only uses its top 27 bits, so fold the faces together and let a 64-bit mix spread them
+    Wide h = (faces[0] << 32 | faces[1]) * 0x9E3779B97F4A7C15ULL;
+    h ^= (faces[2] << 32 | faces[3]) * 0xC2B2AE3D27D4EB4FULL;
+    h ^= (faces[4] << 32 | faces[5]) * 0x165667B19E3779F9ULL;
+    hash = h ^ (h >> 29);
+}
+
+#endif
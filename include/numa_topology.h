@@ -0,0 +1,120 @@
+#ifndef __NUMA_TOPOLOGY_H__
+#define __NUMA_TOPOLOGY_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct NumaNode {
+    int id;
+    std::vector<int> cpus;  // only CPUs this process is allowed to run on
+    uint64_t memoryBytes;   // 0 if unknown
+};
+
+/**
+ * @brief Memory nodes and the CPUs attached to them, read from /sys/devices/system/node on Linux
+ * Anywhere the topology can't be read (other platforms, containers without /sys) this falls back to a single node
+ * holding every CPU, so callers never have to special-case it.
+ */
+class NumaTopology {
+private:
+    std::vector<NumaNode> nodeList;
+    std::vector<int> cpuNode;
+public:
+    static NumaTopology detect();
+
+    const std::vector<NumaNode>& nodes() const { return nodeList; }
+    int numNodes() const { return nodeList.size(); }
+    int numCpus() const;
+
+    // Index into nodes() of the node cpu belongs to, or of the node the calling thread is running on
+    int nodeOfCpu(int cpu) const;
+    int currentNode() const;
+
+    /**
+     * @brief CPUs to pin numThreads workers to, spread round-robin over the nodes so each node gets its share
+     */
+    std::vector<int> workerCpus(int numThreads) const;
+
+    std::string describe() const;
+};
+
+// Pin the calling thread to one CPU, or to every CPU of a node. Return false if pinning isn't supported or failed.
+bool pinThreadToCpu(int cpu);
+bool pinThreadToNode(const NumaTopology& topology, int node);
+
+enum NumaPlacement {
+    NUMA_FIRST_TOUCH,  // one shared copy whose pages are first touched round-robin by every node
+    NUMA_REPLICATE     // one copy per node, written by a thread running on that node
+};
+
+/**
+ * @brief Read-only block of memory placed across NUMA nodes
+ * Pages are mapped untouched and then written from threads pinned to the target node, so the kernel's default
+ * first-touch policy puts them on that node without needing libnuma. create() returns nullptr if the memory can't be
+ * mapped. If a writer couldn't be pinned the data is still complete but may sit on the wrong node; placed() reports
+ * whether every writer ran where it should.
+ */
+class NumaReplicas {
+private:
+    std::vector<void*> copies;
+    size_t bytes;
+    bool pinned;
+    const NumaTopology& topology;
+
+    NumaReplicas(const NumaTopology& topology, size_t bytes);
+public:
+    static std::unique_ptr<NumaReplicas> create(const NumaTopology& topology, const void* source, size_t bytes,
+                                                NumaPlacement placement);
+    ~NumaReplicas();
+
+    NumaReplicas(const NumaReplicas&) = delete;
+    NumaReplicas& operator=(const NumaReplicas&) = delete;
+
+    const void* forNode(int node) const { return copies[copies.size() == 1 ? 0 : node]; }
+    const void* local() const { return forNode(topology.currentNode()); }
+    size_t size() const { return bytes; }
+    bool placed() const { return pinned; }
+};
+
+/**
+ * @brief A read-only table placed with NumaReplicas, handing out a view of the copy nearest each node
+ * Table must provide imageBytes(), writeImage(void*) and a static fromImage(const void*, size_t) returning a
+ * unique_ptr view over an image, as EndgameTable does. create() returns nullptr if the copies can't be made. Workers
+ * should fetch local() once after pinning themselves.
+ */
+template <typename Table>
+class NodeLocalTable {
+private:
+    std::unique_ptr<NumaReplicas> replicas;
+    std::vector<std::unique_ptr<Table>> views;
+    const NumaTopology& topology;
+
+    explicit NodeLocalTable(const NumaTopology& topology) : topology(topology) {}
+public:
+    static std::unique_ptr<NodeLocalTable> create(const Table& table, const NumaTopology& topology,
+                                                  NumaPlacement placement)
+    {
+        std::vector<char> image(table.imageBytes());
+        table.writeImage(image.data());
+
+        std::unique_ptr<NodeLocalTable> local(new NodeLocalTable(topology));
+        local->replicas = NumaReplicas::create(topology, image.data(), image.size(), placement);
+        if (!local->replicas) return nullptr;
+
+        int numViews = placement == NUMA_REPLICATE ? topology.numNodes() : 1;
+        for (int node = 0; node < numViews; ++node) {
+            local->views.push_back(Table::fromImage(local->replicas->forNode(node), image.size()));
+            if (!local->views.back()) return nullptr;
+        }
+        return local;
+    }
+
+    const Table& forNode(int node) const { return *views[views.size() == 1 ? 0 : node]; }
+    const Table& local() const { return forNode(topology.currentNode()); }
+    bool placed() const { return replicas->placed(); }
+};
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef __PERF_COUNTERS_H__
+#define __PERF_COUNTERS_H__
+
+#include <cstdint>
+#include <string>
+
+enum PerfCounterType {
+    PERF_CYCLES = 0,
+    PERF_INSTRUCTIONS,
+    PERF_BRANCH_MISSES,
+    PERF_L1D_MISSES,
+    PERF_LLC_MISSES,
+    PERF_DTLB_MISSES,
+    NUM_PERF_COUNTERS
+};
+
+extern const char* perfCounterNames[NUM_PERF_COUNTERS];
+
+struct PerfSample {
+    uint64_t values[NUM_PERF_COUNTERS];
+    bool valid[NUM_PERF_COUNTERS];
+    double seconds;
+
+    double instructionsPerCycle() const;
+
+    /**
+     * @brief One line with every counter divided by units (e.g. moves or expanded nodes), plus IPC and miss rates
+     * Counters that couldn't be read are shown as n/a.
+     */
+    std::string report(uint64_t units, const char* unitName) const;
+};
+
+/**
+ * @brief Hardware performance counters for the calling thread, via Linux perf_event_open
+ * Create one per thread you want to measure (e.g. per solver worker), then bracket regions with start() and stop().
+ * Counters the kernel won't give us (containers, perf_event_paranoid, missing PMU, other platforms) are skipped, so
+ * this always works and stop() still returns wall-clock time; check available() to see if anything is counted.
+ * The counters are opened as one group led by cycles so they count over the same intervals; if the PMU can't hold the
+ * whole group they are opened separately instead. Counts are scaled when the kernel multiplexes counters.
+ */
+class PerfCounters {
+private:
+    int fds[NUM_PERF_COUNTERS];
+    bool inGroup[NUM_PERF_COUNTERS];
+    int groupSize;
+    double startTime;
+
+    // Stop the group and fill in its counts; false if there is no group or it never ran
+    bool readGroup(PerfSample* sample);
+public:
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool available() const;
+    bool available(PerfCounterType type) const { return fds[type] >= 0; }
+    bool grouped(PerfCounterType type) const { return inGroup[type]; }
+
+    void start();
+    PerfSample stop();
+};
+
+#endif
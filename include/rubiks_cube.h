@@ -1,29 +1,84 @@
 #ifndef __RUBIKS_CUBE_H__
 #define __RUBIKS_CUBE_H__
 
+#include <cstddef>
 #include <cstdint>
 
+#define NUM_FACES 6
+#define FACELETS_PER_FACE 9
+#define NUM_FACELETS (NUM_FACES * FACELETS_PER_FACE)
+#define NUM_CUBIE_SLOTS 20
+
+// Color value that never appears on a real cube, used to blank out facelets we don't care about
+#define DONT_CARE_COLOR 7
+
 enum MoveType { U1 = 0, D1 = 1, R1 = 2, L1 = 3, F1 = 4, B1 = 5 };
 
 extern const char* moveTypeToString[6];
 extern const MoveType availableMoves[6];
 
+/**
+ * @brief Whether next can be skipped after a run of `run` copies of prev in a shortest move sequence
+ * Four quarter turns of a face are the identity, and opposite faces commute so we only search them in one order.
+ */
+inline bool isRedundantMove(MoveType prev, int run, MoveType next)
+{
+    if (run == 0) return false;
+    if (next == prev) return run >= 3;
+    return (next >> 1) == (prev >> 1) && next < prev;
+}
+
+/**
+ * @brief Partial goal over the packed cube layout
+ * A cube satisfies the goal when (data[i] & mask[i]) == pattern[i] for every face, so facelets outside the mask are
+ * ignored. Build goals with the helpers in cube_goal.h rather than by hand.
+ */
+struct CubeGoal {
+    uint32_t mask[NUM_FACES];
+    uint32_t pattern[NUM_FACES];
+};
+
 class RubiksCube {
 private:
     uint32_t data[6];
 public:
     RubiksCube();
+    explicit RubiksCube(const uint32_t faces[6]) : data{faces[0], faces[1], faces[2], faces[3], faces[4], faces[5]} {}
     bool isSolved();
+    bool satisfies(const CubeGoal& goal) const;
     void scramble();
     void move(MoveType type);
 
-    bool operator==(const RubiksCube& other);
-    bool operator!=(const RubiksCube& other);
+    void setFacelet(int face, int index, uint8_t color);
+    const uint32_t* faces() const { return data; }
+    size_t hash() const;
+
+    bool operator==(const RubiksCube& other) const;
+    bool operator!=(const RubiksCube& other) const;
+    bool operator<(const RubiksCube& other) const;
     uint8_t operator()(int face, int index) const;
 };
 
+struct RubiksCubeHash {
+    size_t operator()(const RubiksCube& cube) const { return cube.hash(); }
+};
+
+/**
+ * @brief Facelet-level view of the cube, derived once from RubiksCube::move()
+ * Facelets are numbered face * 9 + index. Each non-center facelet belongs to one of the 20 cubie slots (8 corners,
+ * 12 edges); centers never move and have slot -1.
+ */
+struct CubeGeometry {
+    int movePerm[6][NUM_FACELETS];  // movePerm[m][p] is where the facelet at p ends up after move m
+    int slotOf[NUM_FACELETS];
+    int slotSize[NUM_CUBIE_SLOTS];
+    int slotFacelets[NUM_CUBIE_SLOTS][3];
+};
+
+const CubeGeometry& cubeGeometry();
+
 extern const RubiksCube SOLVED_CUBE;
 
 void printCube(const RubiksCube& cube);
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,79 @@
+#ifndef __SOLUTION_CACHE_H__
+#define __SOLUTION_CACHE_H__
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "cube_symmetry.h"
+#include "rubiks_cube.h"
+
+struct SolutionCacheStats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t inserts;
+    uint64_t evictions;
+    size_t entries;
+    size_t bytes;
+};
+
+/**
+ * @brief Concurrent cache of solutions keyed by canonical cube state
+ * Queries are canonicalized over the 24 whole-cube rotations (and optionally inversion), so a cached solution also
+ * answers every rotated or inverted variant of the state it was stored for. The cache is split into shards with their
+ * own lock and CLOCK eviction, and the total memory charged to entries stays under maxBytes.
+ *
+ * With useInverse, answers mapped through inversion are valid but not necessarily shortest: inverting a clockwise
+ * turn takes three clockwise turns.
+ */
+class SolutionCache {
+private:
+    struct Entry {
+        RubiksCube key;
+        std::vector<uint8_t> moves;
+        bool referenced;
+        bool occupied;
+    };
+
+    struct Shard {
+        std::mutex lock;
+        std::unordered_map<RubiksCube, size_t, RubiksCubeHash> index;
+        std::vector<Entry> slots;
+        std::vector<size_t> freeSlots;
+        size_t hand = 0;
+        size_t bytes = 0;
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    size_t shardBudget;
+    bool useInverse;
+
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+    std::atomic<uint64_t> inserts{0};
+    std::atomic<uint64_t> evictions{0};
+
+    Shard& shardFor(const RubiksCube& key) const;
+    void insertCanonical(const RubiksCube& key, const std::vector<uint8_t>& moves);
+    void evict(Shard& shard);
+public:
+    SolutionCache(size_t maxBytes, int numShards = 16, bool useInverse = true);
+
+    bool lookup(const RubiksCube& cube, std::vector<MoveType>& solution);
+    void insert(const RubiksCube& cube, const std::vector<MoveType>& solution);
+
+    SolutionCacheStats stats() const;
+
+    /**
+     * @brief Write every entry to path, or read a snapshot back in (on top of whatever is already cached)
+     * Returns false if the file can't be opened or isn't a valid snapshot; nothing is loaded from a corrupt or
+     * truncated file.
+     */
+    bool saveSnapshot(const char* path) const;
+    bool loadSnapshot(const char* path);
+};
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef __SOLVER_H__
+#define __SOLVER_H__
+
+#include <cstdint>
+#include <vector>
+
+#include "endgame_table.h"
+#include "rubiks_cube.h"
+
+struct SearchStats {
+    uint64_t nodesExpanded = 0;
+    uint64_t endgameProbes = 0;
+};
+
+/**
+ * @brief IDA* search for a shortest solution of at most maxDepth moves
+ * Once the remaining budget of an iteration drops to the endgame table's depth the search stops descending and
+ * finishes with a single probe, so the deepest levels of every iteration are never expanded.
+ */
+bool solveCube(const RubiksCube& cube, const EndgameTable& endgame, int maxDepth, std::vector<MoveType>& solution,
+               SearchStats* stats = nullptr);
+
+#define BATCH_LANES 8
+
+/**
+ * @brief Solve many independent cubes with lockstep traversals of the move tree
+ * BATCH_LANES cubes share one walk: each move is applied to all lanes at once with the vectorized move kernel, and at
+ * the last level before the endgame every lane's children are hashed together and probed as one batch. Every unsolved
+ * cube goes through one IDA* bound before the next bound starts, so all lanes walk the same tree. A lane whose cube is
+ * solved, or has seen the whole tree, is refilled from the queue on the spot; the new cube starts where the walk is
+ * and wraps around. Solutions are the same length as solveCube() would find.
+ *
+ * The lockstep walk needs AVX2 on x86; without it the cubes are solved one at a time with solveCube(). solved[i]
+ * reports whether cubes[i] was solved within maxDepth; returns the number solved. nodesExpanded in stats counts shared
+ * (lockstep) nodes.
+ */
+int solveCubeBatch(const std::vector<RubiksCube>& cubes, const EndgameTable& endgame, int maxDepth,
+                   std::vector<std::vector<MoveType>>& solutions, std::vector<bool>& solved,
+                   SearchStats* stats = nullptr);
+
+#endif
@@ -0,0 +1,161 @@
+#include "cube_goal.h"
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+#define BITS_PER_COLOR 3
+
+static uint32_t faceletBits(int index, uint32_t value) { return value << (32 - (index + 1) * BITS_PER_COLOR); }
+
+static int faceMaskOfSlot(const CubeGeometry& geo, int slot)
+{
+    int faces = 0;
+    for (int i = 0; i < geo.slotSize[slot]; ++i) faces |= 1 << (geo.slotFacelets[slot][i] / FACELETS_PER_FACE);
+    return faces;
+}
+
+// Goal pinning every facelet of the slots that lie within `faces` and touch all of `required`
+static CubeGoal slotGoal(int faces, int required, bool edgesOnly)
+{
+    const CubeGeometry& geo = cubeGeometry();
+    vector<int> facelets;
+
+    for (int s = 0; s < NUM_CUBIE_SLOTS; ++s) {
+        int slotFaces = faceMaskOfSlot(geo, s);
+        if ((edgesOnly && geo.slotSize[s] != 2) || (slotFaces & ~faces) || (slotFaces & required) != required) continue;
+        for (int i = 0; i < geo.slotSize[s]; ++i) facelets.push_back(geo.slotFacelets[s][i]);
+    }
+
+    return makeFaceletGoal(facelets);
+}
+
+CubeGoal makeFaceletGoal(const vector<int>& facelets)
+{
+    CubeGoal goal = {};
+    for (int p : facelets) {
+        int face = p / FACELETS_PER_FACE, index = p % FACELETS_PER_FACE;
+        goal.mask[face] |= faceletBits(index, DONT_CARE_COLOR);
+        goal.pattern[face] |= faceletBits(index, SOLVED_CUBE(face, index));
+    }
+    return goal;
+}
+
+CubeGoal crossGoal(int face) { return slotGoal(0x3F, 1 << face, true); }
+
+CubeGoal blockGoal(int faceA, int faceB, int faceC)
+{
+    return slotGoal((1 << faceA) | (1 << faceB) | (1 << faceC), 0, false);
+}
+
+CubeGoal firstTwoLayersGoal(int face)
+{
+    // Faces 0/5, 1/3 and 2/4 are opposite each other
+    static const int OPPOSITE_FACE[NUM_FACES] = {5, 3, 4, 1, 2, 0};
+    return slotGoal(0x3F & ~(1 << OPPOSITE_FACE[face]), 0, false);
+}
+
+CubeGoal orientLastLayerGoal(int face)
+{
+    vector<int> facelets;
+    for (int i = 0; i < FACELETS_PER_FACE; ++i) facelets.push_back(face * FACELETS_PER_FACE + i);
+    return makeFaceletGoal(facelets);
+}
+
+GoalPruningTable::GoalPruningTable(const CubeGoal& goal, int maxDepth) : target(goal), depthLimit(maxDepth), keep{}
+{
+    assert(SOLVED_CUBE.satisfies(goal) && "Goal must hold on the solved cube");
+    const CubeGeometry& geo = cubeGeometry();
+
+    // A sticker is identified by the colors of its cubie plus its own color. Keep every sticker the goal pins in
+    // the solved state; all other stickers are indistinguishable to the goal.
+    for (int p = 0; p < NUM_FACELETS; ++p) {
+        int face = p / FACELETS_PER_FACE, index = p % FACELETS_PER_FACE;
+        int s = geo.slotOf[p];
+        if (s < 0 || !(goal.mask[face] & faceletBits(index, DONT_CARE_COLOR))) continue;
+        keep[faceMaskOfSlot(geo, s)][face] = true;
+    }
+
+    // Breadth-first search outwards from the solved projection. We only have clockwise turns, so distances are not
+    // symmetric: expand with inverse moves (three clockwise turns) to get the distance *to* the goal.
+    ChunkPool pool;
+    FrontierBuffer frontier(pool), next(pool);
+    frontier.push_back(project(SOLVED_CUBE));
+    distance[project(SOLVED_CUBE)] = 0;
+
+    for (int depth = 1; depth <= maxDepth && !frontier.empty(); ++depth) {
+        frontier.forEach([&](const RubiksCube& state) {
+            for (auto m : availableMoves) {
+                RubiksCube child = state;
+                child.move(m);
+                child.move(m);
+                child.move(m);
+                if (distance.emplace(child, depth).second) next.push_back(child);
+            }
+        });
+        frontier.swap(next);
+        next.clear();
+    }
+}
+
+RubiksCube GoalPruningTable::project(const RubiksCube& cube) const
+{
+    const CubeGeometry& geo = cubeGeometry();
+    RubiksCube projected;
+
+    for (int p = 0; p < NUM_FACELETS; ++p) {
+        int face = p / FACELETS_PER_FACE, index = p % FACELETS_PER_FACE;
+        int s = geo.slotOf[p];
+        uint8_t color = DONT_CARE_COLOR;
+
+        if (s >= 0) {
+            int cubieColors = 0;
+            for (int i = 0; i < geo.slotSize[s]; ++i) {
+                int q = geo.slotFacelets[s][i];
+                cubieColors |= 1 << cube(q / FACELETS_PER_FACE, q % FACELETS_PER_FACE);
+            }
+            uint8_t own = cube(face, index);
+            if (keep[cubieColors][own]) color = own;
+        }
+
+        projected.setFacelet(face, index, color);
+    }
+
+    return projected;
+}
+
+int GoalPruningTable::lowerBound(const RubiksCube& cube) const
+{
+    auto it = distance.find(project(cube));
+    return it == distance.end() ? depthLimit + 1 : it->second;
+}
+
+static bool searchGoal(const RubiksCube& cube, const GoalPruningTable& table, int depth, int bound, MoveType prev,
+                       int run, vector<MoveType>& path)
+{
+    if (cube.satisfies(table.goal())) return true;
+    if (depth + table.lowerBound(cube) > bound) return false;
+
+    for (auto m : availableMoves) {
+        if (isRedundantMove(prev, run, m)) continue;
+
+        RubiksCube child = cube;
+        child.move(m);
+        path.push_back(m);
+        if (searchGoal(child, table, depth + 1, bound, m, m == prev ? run + 1 : 1, path)) return true;
+        path.pop_back();
+    }
+
+    return false;
+}
+
+bool solveGoal(const RubiksCube& cube, const GoalPruningTable& table, int maxDepth, vector<MoveType>& solution)
+{
+    solution.clear();
+    for (int bound = 0; bound <= maxDepth; ++bound) {
+        if (searchGoal(cube, table, 0, bound, U1, 0, solution)) return true;
+    }
+    return false;
+}
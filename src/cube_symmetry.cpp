@@ -0,0 +1,234 @@
+#include "cube_symmetry.h"
+
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+// Face each move turns: U1 -> 0, D1 -> 5, R1 -> 3, L1 -> 1, F1 -> 2, B1 -> 4
+static const int MOVE_FACE[6] = {0, 5, 3, 1, 2, 4};
+static const MoveType FACE_MOVE[NUM_FACES] = {U1, L1, F1, R1, B1, D1};
+
+struct Vec3 {
+    int x, y, z;
+    bool operator==(const Vec3& other) const { return x == other.x && y == other.y && z == other.z; }
+};
+
+/**
+ * @brief Position of a facelet's center and its outward normal, on a cube spanning [-1, 1] on every axis
+ * The net has U on top of L F R B with D below. U's top row touches B, D's top row touches F, and B is stored as
+ * seen from behind.
+ */
+static void faceletCoordinates(int p, Vec3& position, Vec3& normal)
+{
+    int face = p / FACELETS_PER_FACE, row = (p % FACELETS_PER_FACE) / 3, col = p % 3;
+    switch (face) {
+        case 0: position = {col - 1, 1, row - 1}; normal = {0, 1, 0}; break;
+        case 1: position = {-1, 1 - row, col - 1}; normal = {-1, 0, 0}; break;
+        case 2: position = {col - 1, 1 - row, 1}; normal = {0, 0, 1}; break;
+        case 3: position = {1, 1 - row, 1 - col}; normal = {1, 0, 0}; break;
+        case 4: position = {1 - col, 1 - row, -1}; normal = {0, 0, -1}; break;
+        default: position = {col - 1, -1, 1 - row}; normal = {0, -1, 0}; break;
+    }
+}
+
+// Quarter turns of the whole cube about the x and y axes
+static Vec3 rotateX(const Vec3& v) { return {v.x, -v.z, v.y}; }
+static Vec3 rotateY(const Vec3& v) { return {v.z, v.y, -v.x}; }
+
+static int findFacelet(const Vec3& position, const Vec3& normal)
+{
+    for (int p = 0; p < NUM_FACELETS; ++p) {
+        Vec3 otherPosition, otherNormal;
+        faceletCoordinates(p, otherPosition, otherNormal);
+        if (otherPosition == position && otherNormal == normal) return p;
+    }
+    return -1;
+}
+
+static vector<int> rotationPerm(Vec3 (*rotate)(const Vec3&))
+{
+    vector<int> perm(NUM_FACELETS);
+    for (int p = 0; p < NUM_FACELETS; ++p) {
+        Vec3 position, normal;
+        faceletCoordinates(p, position, normal);
+        perm[p] = findFacelet(rotate(position), rotate(normal));
+    }
+    return perm;
+}
+
+static void finishSymmetry(CubeSymmetry& symmetry)
+{
+    for (int face = 0; face < NUM_FACES; ++face) {
+        int center = face * FACELETS_PER_FACE + 4;
+        symmetry.colorMap[face] = symmetry.perm[center] / FACELETS_PER_FACE;
+    }
+    for (int m = 0; m < 6; ++m) {
+        MoveType mapped = FACE_MOVE[symmetry.colorMap[MOVE_FACE[m]]];
+        symmetry.moveMap[m] = mapped;
+        symmetry.inverseMoveMap[mapped] = availableMoves[m];
+    }
+}
+
+static vector<CubeSymmetry> buildCubeSymmetries()
+{
+    vector<int> generators[2] = {rotationPerm(rotateX), rotationPerm(rotateY)};
+
+    // Close {identity} under the two generators; the rotation group of the cube has 24 elements
+    vector<vector<int>> perms(1, vector<int>(NUM_FACELETS));
+    for (int p = 0; p < NUM_FACELETS; ++p) perms[0][p] = p;
+
+    for (size_t i = 0; i < perms.size(); ++i) {
+        for (auto& generator : generators) {
+            vector<int> next(NUM_FACELETS);
+            for (int p = 0; p < NUM_FACELETS; ++p) next[p] = generator[perms[i][p]];
+
+            bool seen = false;
+            for (auto& perm : perms) seen = seen || perm == next;
+            if (!seen) perms.push_back(next);
+        }
+    }
+
+    vector<CubeSymmetry> symmetries(perms.size());
+    for (size_t i = 0; i < perms.size(); ++i) {
+        for (int p = 0; p < NUM_FACELETS; ++p) symmetries[i].perm[p] = perms[i][p];
+        finishSymmetry(symmetries[i]);
+    }
+    return symmetries;
+}
+
+const CubeSymmetry* cubeSymmetries()
+{
+    static const vector<CubeSymmetry> symmetries = buildCubeSymmetries();
+    return symmetries.data();
+}
+
+static void unpackFacelets(const RubiksCube& cube, uint8_t colors[NUM_FACELETS])
+{
+    for (int p = 0; p < NUM_FACELETS; ++p) colors[p] = cube(p / FACELETS_PER_FACE, p % FACELETS_PER_FACE);
+}
+
+static RubiksCube packFacelets(const uint8_t colors[NUM_FACELETS])
+{
+    uint32_t faces[NUM_FACES] = {};
+    for (int p = 0; p < NUM_FACELETS; ++p) {
+        faces[p / FACELETS_PER_FACE] |= uint32_t(colors[p]) << (32 - (p % FACELETS_PER_FACE + 1) * 3);
+    }
+    return RubiksCube(faces);
+}
+
+static RubiksCube applySymmetry(const uint8_t colors[NUM_FACELETS], const CubeSymmetry& symmetry)
+{
+    uint8_t image[NUM_FACELETS];
+    for (int p = 0; p < NUM_FACELETS; ++p) image[symmetry.perm[p]] = symmetry.colorMap[colors[p]];
+    return packFacelets(image);
+}
+
+RubiksCube applySymmetry(const RubiksCube& cube, const CubeSymmetry& symmetry)
+{
+    uint8_t colors[NUM_FACELETS];
+    unpackFacelets(cube, colors);
+    return applySymmetry(colors, symmetry);
+}
+
+// A cubie is identified by its set of colors, which is the set of faces of its home slot
+static vector<int> buildHomeSlots()
+{
+    const CubeGeometry& geo = cubeGeometry();
+    vector<int> homeSlot(1 << NUM_FACES, -1);
+    for (int s = 0; s < NUM_CUBIE_SLOTS; ++s) {
+        int faces = 0;
+        for (int i = 0; i < geo.slotSize[s]; ++i) faces |= 1 << (geo.slotFacelets[s][i] / FACELETS_PER_FACE);
+        homeSlot[faces] = s;
+    }
+    return homeSlot;
+}
+
+RubiksCube invertCube(const RubiksCube& cube)
+{
+    const CubeGeometry& geo = cubeGeometry();
+    static const vector<int> homeSlot = buildHomeSlots();
+
+    // The sticker at p came from the facelet of its home slot on the face matching its color. The inverse puts
+    // p's face color back at that facelet.
+    RubiksCube result;
+    for (int s = 0; s < NUM_CUBIE_SLOTS; ++s) {
+        int colors = 0;
+        for (int i = 0; i < geo.slotSize[s]; ++i) {
+            int p = geo.slotFacelets[s][i];
+            colors |= 1 << cube(p / FACELETS_PER_FACE, p % FACELETS_PER_FACE);
+        }
+        int home = homeSlot[colors];
+
+        for (int i = 0; i < geo.slotSize[s]; ++i) {
+            int p = geo.slotFacelets[s][i];
+            int color = cube(p / FACELETS_PER_FACE, p % FACELETS_PER_FACE);
+            for (int j = 0; j < geo.slotSize[home]; ++j) {
+                int q = geo.slotFacelets[home][j];
+                if (q / FACELETS_PER_FACE == color) {
+                    result.setFacelet(q / FACELETS_PER_FACE, q % FACELETS_PER_FACE, p / FACELETS_PER_FACE);
+                }
+            }
+        }
+    }
+    return result;
+}
+
+vector<MoveType> invertMoves(const vector<MoveType>& moves)
+{
+    // Count turns per run of the same face so X X X X cancels instead of growing the sequence
+    vector<MoveType> faces;
+    vector<int> turns;
+    for (auto it = moves.rbegin(); it != moves.rend(); ++it) {
+        if (!faces.empty() && faces.back() == *it) {
+            turns.back() += 3;
+        } else {
+            faces.push_back(*it);
+            turns.push_back(3);
+        }
+    }
+
+    vector<MoveType> inverted;
+    for (size_t i = 0; i < faces.size(); ++i) {
+        for (int t = 0; t < turns[i] % 4; ++t) inverted.push_back(faces[i]);
+    }
+    return inverted;
+}
+
+CanonicalForm canonicalize(const RubiksCube& cube, bool useInverse)
+{
+    const CubeSymmetry* symmetries = cubeSymmetries();
+    CanonicalForm best = {cube, 0, false};
+
+    RubiksCube candidates[2] = {cube, useInverse ? invertCube(cube) : cube};
+    for (int inverted = 0; inverted < (useInverse ? 2 : 1); ++inverted) {
+        uint8_t colors[NUM_FACELETS];
+        unpackFacelets(candidates[inverted], colors);
+
+        for (int k = 0; k < NUM_CUBE_SYMMETRIES; ++k) {
+            RubiksCube image = k == 0 ? candidates[inverted] : applySymmetry(colors, symmetries[k]);
+            if (image < best.cube) best = {image, k, inverted == 1};
+        }
+    }
+    return best;
+}
+
+vector<MoveType> mapSolution(const vector<MoveType>& canonicalSolution, const CanonicalForm& form)
+{
+    const CubeSymmetry& symmetry = cubeSymmetries()[form.symmetry];
+
+    vector<MoveType> solution;
+    for (auto m : canonicalSolution) solution.push_back(symmetry.inverseMoveMap[m]);
+
+    // A solution of the inverse state is the scramble itself, so undo it
+    return form.inverted ? invertMoves(solution) : solution;
+}
+
+vector<MoveType> canonicalSolution(const vector<MoveType>& solution, const CanonicalForm& form)
+{
+    const CubeSymmetry& symmetry = cubeSymmetries()[form.symmetry];
+
+    vector<MoveType> mapped;
+    for (auto m : form.inverted ? invertMoves(solution) : solution) mapped.push_back(symmetry.moveMap[m]);
+    return mapped;
+}
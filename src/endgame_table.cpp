@@ -0,0 +1,264 @@
+#include "endgame_table.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "frontier_pool.h"
+
+using namespace std;
+
+#define ENDGAME_MAGIC 0x54474E45  // "ENGT"
+#define ENDGAME_VERSION 1
+
+// Low bits of each face word are unused by the facelets
+const uint32_t FACE_BITS_MASK = 0xFFFFFFE0;
+const uint32_t SPARE_BITS_MASK = ~FACE_BITS_MASK;
+
+struct EndgameHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t depth;
+    uint32_t reserved;
+    uint64_t capacity;
+    uint64_t count;
+};
+
+EndgameTable::EndgameTable() : entries(nullptr), capacity(0), count(0), maxDepth(0), mapping(nullptr), mappingBytes(0)
+{
+}
+
+EndgameTable::EndgameTable(int depth) : EndgameTable()
+{
+    maxDepth = depth;
+
+    capacity = 1024;
+    storage.assign(capacity, Entry{});
+    entries = storage.data();
+    insert(SOLVED_CUBE, 0, U1);
+
+    // Breadth-first search outwards from solved, one level per distance
+    ChunkPool pool;
+    FrontierBuffer frontier(pool), next(pool);
+    frontier.push_back(SOLVED_CUBE);
+    for (int distance = 1; distance <= depth; ++distance) {
+        frontier.forEach([&](const RubiksCube& state) {
+            for (auto m : availableMoves) {
+                // We only have clockwise turns: the predecessor that reaches state with m is state followed by m'
+                RubiksCube previous = state;
+                previous.move(m);
+                previous.move(m);
+                previous.move(m);
+
+                // Keep the load factor under one half so probes stay short
+                if (2 * (count + 1) > capacity) grow();
+                if (insert(previous, distance, m)) next.push_back(previous);
+            }
+        });
+        // The finished level's chunks go back to the pool and refill as the next level
+        frontier.swap(next);
+        next.clear();
+    }
+}
+
+void EndgameTable::grow()
+{
+    vector<Entry> old;
+    old.swap(storage);
+    capacity *= 2;
+    storage.assign(capacity, Entry{});
+    entries = storage.data();
+    count = 0;
+
+    for (const Entry& entry : old) {
+        if (entry.words[1] == 0) continue;
+
+        uint32_t faces[6];
+        for (int i = 0; i < 6; ++i) faces[i] = entry.words[i] & FACE_BITS_MASK;
+        insert(RubiksCube(faces), entry.words[0] & SPARE_BITS_MASK, availableMoves[entry.words[1] & SPARE_BITS_MASK]);
+    }
+}
+
+EndgameTable::~EndgameTable()
+{
+    if (mapping) munmap(mapping, mappingBytes);
+}
+
+const EndgameTable::Entry* EndgameTable::find(const RubiksCube& cube, size_t slot) const
+{
+    const uint32_t* faces = cube.faces();
+    for (;; slot = (slot + 1) & (capacity - 1)) {
+        const Entry& entry = entries[slot];
+        // Face 1 always has its center set, so an all-zero word marks an empty slot
+        if (entry.words[1] == 0) return nullptr;
+
+        bool match = true;
+        for (int i = 0; i < 6; ++i) match = match && (entry.words[i] & FACE_BITS_MASK) == faces[i];
+        if (match) return &entry;
+    }
+}
+
+bool EndgameTable::insert(const RubiksCube& cube, int distance, MoveType nextMove)
+{
+    const uint32_t* faces = cube.faces();
+    for (uint64_t slot = cube.hash() & (capacity - 1);; slot = (slot + 1) & (capacity - 1)) {
+        Entry& entry = storage[slot];
+        if (entry.words[1] == 0) {
+            for (int i = 0; i < 6; ++i) entry.words[i] = faces[i];
+            entry.words[0] |= distance;
+            entry.words[1] |= nextMove;
+            ++count;
+            return true;
+        }
+
+        bool match = true;
+        for (int i = 0; i < 6; ++i) match = match && (entry.words[i] & FACE_BITS_MASK) == faces[i];
+        if (match) return false;
+    }
+}
+
+bool EndgameTable::probe(const RubiksCube& cube, int& distance, MoveType& nextMove) const
+{
+    const Entry* entry = find(cube, slotOf(cube));
+    if (!entry) return false;
+
+    distance = entry->words[0] & SPARE_BITS_MASK;
+    nextMove = availableMoves[entry->words[1] & SPARE_BITS_MASK];
+    return true;
+}
+
+int EndgameTable::lowerBound(const RubiksCube& cube, size_t slot) const
+{
+    const Entry* entry = find(cube, slot);
+    return entry ? int(entry->words[0] & SPARE_BITS_MASK) : maxDepth + 1;
+}
+
+uint32_t EndgameTable::findLanes(const uint32_t* faces, int stride, const size_t* slots, uint32_t lanes) const
+{
+    uint32_t found = 0, colliding = 0;
+    for (uint32_t rest = lanes; rest; rest &= rest - 1) {
+        int i = __builtin_ctz(rest);
+        const Entry& entry = entries[slots[i]];
+        uint32_t diff = 0;
+        for (int f = 0; f < 6; ++f) diff |= (entry.words[f] & FACE_BITS_MASK) ^ faces[f * stride + i];
+        found |= uint32_t(diff == 0) << i;
+        colliding |= (uint32_t(diff != 0) & uint32_t(entry.words[1] != 0)) << i;
+    }
+
+    // Home slots taken by another cube: finish those probes one at a time
+    for (; colliding; colliding &= colliding - 1) {
+        int i = __builtin_ctz(colliding);
+        uint32_t cube[6];
+        for (int f = 0; f < 6; ++f) cube[f] = faces[f * stride + i];
+        if (find(RubiksCube(cube), (slots[i] + 1) & (capacity - 1))) found |= 1u << i;
+    }
+    return found;
+}
+
+bool EndgameTable::appendSolution(const RubiksCube& cube, vector<MoveType>& solution) const
+{
+    RubiksCube state = cube;
+    int distance;
+    MoveType next;
+
+    // Each step must be stored one closer to solved, which also stops a corrupt table from cycling forever
+    size_t start = solution.size();
+    if (!probe(state, distance, next)) return false;
+    while (distance > 0) {
+        int expected = distance - 1;
+        solution.push_back(next);
+        state.move(next);
+        if (!probe(state, distance, next) || distance != expected) {
+            solution.resize(start);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool EndgameTable::save(const char* path) const
+{
+    FILE* fp = fopen(path, "wb");
+    if (!fp) return false;
+
+    EndgameHeader header = {ENDGAME_MAGIC, ENDGAME_VERSION, uint32_t(maxDepth), 0, capacity, count};
+    bool ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+    ok = ok && fwrite(entries, sizeof(Entry), capacity, fp) == capacity;
+
+    return fclose(fp) == 0 && ok;
+}
+
+size_t EndgameTable::imageBytes() const { return sizeof(EndgameHeader) + capacity * sizeof(Entry); }
+
+void EndgameTable::writeImage(void* image) const
+{
+    EndgameHeader header = {ENDGAME_MAGIC, ENDGAME_VERSION, uint32_t(maxDepth), 0, capacity, count};
+    memcpy(image, &header, sizeof(header));
+    memcpy(static_cast<char*>(image) + sizeof(header), entries, capacity * sizeof(Entry));
+}
+
+unique_ptr<EndgameTable> EndgameTable::fromImage(const void* image, size_t bytes)
+{
+    if (bytes < sizeof(EndgameHeader)) return nullptr;
+
+    const EndgameHeader* header = static_cast<const EndgameHeader*>(image);
+    uint64_t capacity = header->capacity;
+    // Bound the capacity by the bytes before multiplying, or a huge capacity wraps around to the image size
+    bool valid = header->magic == ENDGAME_MAGIC && header->version == ENDGAME_VERSION && capacity > 0 &&
+                 (capacity & (capacity - 1)) == 0 && capacity <= (bytes - sizeof(EndgameHeader)) / sizeof(Entry) &&
+                 bytes == sizeof(EndgameHeader) + capacity * sizeof(Entry);
+    if (!valid || header->depth > SPARE_BITS_MASK || header->count >= capacity) return nullptr;
+
+    // Probes stop at the first empty slot, so a full table would never end a miss. Count the entries ourselves and
+    // check their distances and moves before trusting the header.
+    const Entry* entries = reinterpret_cast<const Entry*>(static_cast<const char*>(image) + sizeof(EndgameHeader));
+    uint64_t count = 0;
+    for (uint64_t slot = 0; slot < capacity; ++slot) {
+        const Entry& entry = entries[slot];
+        if (entry.words[1] == 0) continue;
+        if ((entry.words[0] & SPARE_BITS_MASK) > header->depth || (entry.words[1] & SPARE_BITS_MASK) >= 6) {
+            return nullptr;
+        }
+        ++count;
+    }
+    if (count != header->count) return nullptr;
+
+    unique_ptr<EndgameTable> table(new EndgameTable());
+    table->entries = entries;
+    table->capacity = capacity;
+    table->count = header->count;
+    table->maxDepth = header->depth;
+    return table;
+}
+
+unique_ptr<EndgameTable> EndgameTable::load(const char* path)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return nullptr;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        return nullptr;
+    }
+
+    void* mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) return nullptr;
+
+    unique_ptr<EndgameTable> table = fromImage(mapping, info.st_size);
+    if (!table) {
+        munmap(mapping, info.st_size);
+        return nullptr;
+    }
+
+    table->mapping = mapping;
+    table->mappingBytes = info.st_size;
+    return table;
+}
@@ -0,0 +1,113 @@
+#include "frontier_pool.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace std;
+
+#define CACHE_LINE_BYTES 64
+#define SLAB_BYTES (256 * 1024)
+
+static void* allocateChunk(size_t bytes)
+{
+    void* chunk = aligned_alloc(CACHE_LINE_BYTES, bytes);
+    if (!chunk) {
+        fprintf(stderr, "Out of memory allocating a %zu byte chunk\n", bytes);
+        exit(1);
+    }
+    return chunk;
+}
+
+ChunkPool::~ChunkPool()
+{
+    for (void* chunk : chunks) free(chunk);
+}
+
+void* ChunkPool::acquire()
+{
+    if (!freeChunks.empty()) {
+        void* chunk = freeChunks.back();
+        freeChunks.pop_back();
+        return chunk;
+    }
+
+    void* chunk = allocateChunk(POOL_CHUNK_BYTES);
+    chunks.push_back(chunk);
+    freeChunks.reserve(chunks.size());
+    return chunk;
+}
+
+void ChunkPool::release(void* chunk) { freeChunks.push_back(chunk); }
+
+ChunkPool& ChunkPool::local()
+{
+    thread_local ChunkPool pool;
+    return pool;
+}
+
+FrontierBuffer::FrontierBuffer(ChunkPool& chunkPool)
+    : pool(&chunkPool), tail(nullptr), tailEnd(nullptr), count(0)
+{
+}
+
+void FrontierBuffer::addChunk()
+{
+    tail = static_cast<RubiksCube*>(pool->acquire());
+    tailEnd = tail + CUBES_PER_CHUNK;
+    chunks.push_back(tail);
+}
+
+void FrontierBuffer::clear()
+{
+    // Keep the chunk list's capacity so refilling the buffer doesn't reallocate it
+    for (RubiksCube* chunk : chunks) pool->release(chunk);
+    chunks.clear();
+    tail = tailEnd = nullptr;
+    count = 0;
+}
+
+void FrontierBuffer::swap(FrontierBuffer& other)
+{
+    std::swap(pool, other.pool);
+    chunks.swap(other.chunks);
+    std::swap(tail, other.tail);
+    std::swap(tailEnd, other.tailEnd);
+    std::swap(count, other.count);
+}
+
+PoolArena::PoolArena() : freeLists{}, bump(nullptr), bumpEnd(nullptr) {}
+
+PoolArena::~PoolArena()
+{
+    for (void* slab : slabs) free(slab);
+}
+
+void* PoolArena::allocate(size_t bytes)
+{
+    size_t sizeClass = (bytes + BLOCK_ALIGN - 1) / BLOCK_ALIGN - 1;
+    if (FreeBlock* block = freeLists[sizeClass]) {
+        freeLists[sizeClass] = block->next;
+        return block;
+    }
+
+    size_t blockBytes = (sizeClass + 1) * BLOCK_ALIGN;
+    if (size_t(bumpEnd - bump) < blockBytes) {
+        bump = static_cast<char*>(allocateChunk(SLAB_BYTES));
+        bumpEnd = bump + SLAB_BYTES;
+        slabs.push_back(bump);
+    }
+
+    void* block = bump;
+    bump += blockBytes;
+    return block;
+}
+
+void PoolArena::deallocate(void* block, size_t bytes)
+{
+    size_t sizeClass = (bytes + BLOCK_ALIGN - 1) / BLOCK_ALIGN - 1;
+    FreeBlock* freed = static_cast<FreeBlock*>(block);
+    freed->next = freeLists[sizeClass];
+    freeLists[sizeClass] = freed;
+}
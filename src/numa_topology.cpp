@@ -0,0 +1,247 @@
+#include "numa_topology.h"
+
+#if defined(__linux__)
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#endif
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Granularity at which NUMA_FIRST_TOUCH spreads a shared copy over the nodes
+const size_t FIRST_TOUCH_CHUNK = 2 * 1024 * 1024;
+
+#if defined(__linux__)
+// Parse a sysfs CPU list such as "0-3,8-11"
+static vector<int> parseCpuList(const char* text)
+{
+    vector<int> cpus;
+    const char* p = text;
+    while (*p) {
+        char* end;
+        long first = strtol(p, &end, 10);
+        if (end == p) break;
+
+        long last = first;
+        if (*end == '-') {
+            p = end + 1;
+            last = strtol(p, &end, 10);
+        }
+        for (long cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+
+        p = end;
+        while (*p == ',' || *p == '\n' || *p == ' ') ++p;
+    }
+    return cpus;
+}
+
+static bool readFile(const string& path, char* buffer, size_t size)
+{
+    FILE* fp = fopen(path.c_str(), "r");
+    if (!fp) return false;
+
+    size_t length = fread(buffer, 1, size - 1, fp);
+    buffer[length] = '\0';
+    fclose(fp);
+    return length > 0;
+}
+#endif
+
+NumaTopology NumaTopology::detect()
+{
+    NumaTopology topology;
+
+#if defined(__linux__)
+    cpu_set_t allowed;
+    bool haveAffinity = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+#else
+    bool haveAffinity = false;
+#endif
+
+#if defined(__linux__)
+    const char* root = "/sys/devices/system/node";
+    DIR* dir = opendir(root);
+    if (dir) {
+        while (dirent* entry = readdir(dir)) {
+            int id;
+            if (sscanf(entry->d_name, "node%d", &id) != 1) continue;
+
+            char buffer[4096];
+            string nodePath = string(root) + "/" + entry->d_name;
+            if (!readFile(nodePath + "/cpulist", buffer, sizeof(buffer))) continue;
+
+            NumaNode node = {id, {}, 0};
+            for (int cpu : parseCpuList(buffer)) {
+                if (!haveAffinity || (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed))) node.cpus.push_back(cpu);
+            }
+
+            if (readFile(nodePath + "/meminfo", buffer, sizeof(buffer))) {
+                const char* total = strstr(buffer, "MemTotal:");
+                unsigned long long kb;
+                if (total && sscanf(total, "MemTotal: %llu kB", &kb) == 1) node.memoryBytes = kb * 1024;
+            }
+
+            // Memory-only nodes (or nodes whose CPUs we may not use) can't host workers
+            if (!node.cpus.empty()) topology.nodeList.push_back(node);
+        }
+        closedir(dir);
+    }
+#endif
+
+    if (topology.nodeList.empty()) {
+        NumaNode node = {0, {}, 0};
+#if defined(__linux__)
+        for (int cpu = 0; haveAffinity && cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &allowed)) node.cpus.push_back(cpu);
+        }
+#endif
+        if (!haveAffinity || node.cpus.empty()) {
+            int numCpus = max(1u, thread::hardware_concurrency());
+            for (int cpu = 0; cpu < numCpus; ++cpu) node.cpus.push_back(cpu);
+        }
+        topology.nodeList.push_back(node);
+    }
+
+    sort(topology.nodeList.begin(), topology.nodeList.end(),
+         [](const NumaNode& a, const NumaNode& b) { return a.id < b.id; });
+
+    for (size_t i = 0; i < topology.nodeList.size(); ++i) {
+        for (int cpu : topology.nodeList[i].cpus) {
+            if (cpu >= (int)topology.cpuNode.size()) topology.cpuNode.resize(cpu + 1, -1);
+            topology.cpuNode[cpu] = i;
+        }
+    }
+
+    return topology;
+}
+
+int NumaTopology::numCpus() const
+{
+    int total = 0;
+    for (auto& node : nodeList) total += node.cpus.size();
+    return total;
+}
+
+int NumaTopology::nodeOfCpu(int cpu) const
+{
+    if (cpu < 0 || cpu >= (int)cpuNode.size() || cpuNode[cpu] < 0) return 0;
+    return cpuNode[cpu];
+}
+
+int NumaTopology::currentNode() const
+{
+#if defined(__linux__)
+    if (nodeList.size() > 1) return nodeOfCpu(sched_getcpu());
+#endif
+    return 0;
+}
+
+vector<int> NumaTopology::workerCpus(int numThreads) const
+{
+    vector<int> cpus;
+    for (int i = 0; i < numThreads; ++i) {
+        const NumaNode& node = nodeList[i % nodeList.size()];
+        cpus.push_back(node.cpus[(i / nodeList.size()) % node.cpus.size()]);
+    }
+    return cpus;
+}
+
+string NumaTopology::describe() const
+{
+    string text = to_string(nodeList.size()) + (nodeList.size() == 1 ? " NUMA node" : " NUMA nodes");
+    for (auto& node : nodeList) {
+        text += "\n  node " + to_string(node.id) + ": " + to_string(node.cpus.size()) + " cpus [";
+        for (size_t i = 0; i < node.cpus.size(); ++i) {
+            if (i) text += ",";
+            text += to_string(node.cpus[i]);
+        }
+        text += "]";
+        if (node.memoryBytes) text += ", " + to_string(node.memoryBytes >> 20) + " MB";
+    }
+    return text;
+}
+
+bool pinThreadToCpu(int cpu)
+{
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+bool pinThreadToNode(const NumaTopology& topology, int node)
+{
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : topology.nodes()[node].cpus) CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+NumaReplicas::NumaReplicas(const NumaTopology& topology, size_t bytes) : bytes(bytes), pinned(true), topology(topology)
+{
+}
+
+unique_ptr<NumaReplicas> NumaReplicas::create(const NumaTopology& topology, const void* source, size_t bytes,
+                                              NumaPlacement placement)
+{
+    unique_ptr<NumaReplicas> replicas(new NumaReplicas(topology, bytes));
+    vector<void*>& copies = replicas->copies;
+
+    int numCopies = placement == NUMA_REPLICATE ? topology.numNodes() : 1;
+    for (int i = 0; i < numCopies; ++i) {
+        // Anonymous mappings aren't backed by pages until first written, which is what lets us choose the node
+        void* copy = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (copy == MAP_FAILED) return nullptr;
+        copies.push_back(copy);
+    }
+
+    // One writer per node, pinned there: either its own full copy, or its round-robin share of the shared copy's
+    // chunks
+    vector<thread> writers;
+    vector<char> pinnedWriters(topology.numNodes());
+    for (int node = 0; node < topology.numNodes(); ++node) {
+        writers.emplace_back([&, node]() {
+            pinnedWriters[node] = pinThreadToNode(topology, node);
+            const char* from = static_cast<const char*>(source);
+
+            if (placement == NUMA_REPLICATE) {
+                memcpy(copies[node], from, bytes);
+                return;
+            }
+
+            char* to = static_cast<char*>(copies[0]);
+            size_t stride = FIRST_TOUCH_CHUNK * topology.numNodes();
+            for (size_t offset = node * FIRST_TOUCH_CHUNK; offset < bytes; offset += stride) {
+                memcpy(to + offset, from + offset, min(FIRST_TOUCH_CHUNK, bytes - offset));
+            }
+        });
+    }
+    for (auto& writer : writers) writer.join();
+
+    for (char pinned : pinnedWriters) replicas->pinned = replicas->pinned && pinned;
+    for (void* copy : copies) mprotect(copy, bytes, PROT_READ);
+    return replicas;
+}
+
+NumaReplicas::~NumaReplicas()
+{
+    for (void* copy : copies) munmap(copy, bytes);
+}
@@ -0,0 +1,217 @@
+#include "perf_counters.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "cycle_timer.h"
+
+using namespace std;
+
+const char* perfCounterNames[NUM_PERF_COUNTERS] = {"cycles",      "instructions", "branch-misses",
+                                                   "L1d-misses", "LLC-misses",   "dTLB-misses"};
+
+#if defined(__linux__)
+static uint64_t cacheMissConfig(uint64_t cache)
+{
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+// groupFd -1 opens a standalone counter, or the leader of a group when grouped is set
+static int openCounter(PerfCounterType type, int groupFd, bool grouped)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.disabled = groupFd < 0;  // group members start and stop with their leader
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    if (grouped) attr.read_format |= PERF_FORMAT_GROUP;
+
+    if (type == PERF_CYCLES || type == PERF_INSTRUCTIONS || type == PERF_BRANCH_MISSES) {
+        static const uint64_t HARDWARE_EVENTS[3] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                                    PERF_COUNT_HW_BRANCH_MISSES};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = HARDWARE_EVENTS[type];
+    } else {
+        static const uint64_t CACHES[3] = {PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_DTLB};
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = cacheMissConfig(CACHES[type - PERF_L1D_MISSES]);
+    }
+
+    // pid 0, cpu -1: this thread, wherever it runs
+    return syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0);
+}
+
+// Scale up if the kernel only had the counter on the PMU part of the time
+static uint64_t scaleCount(uint64_t value, uint64_t enabled, uint64_t running)
+{
+    return running < enabled ? uint64_t(double(value) * enabled / running) : value;
+}
+#endif
+
+PerfCounters::PerfCounters() : inGroup{}, groupSize(0), startTime(0)
+{
+    for (int i = 0; i < NUM_PERF_COUNTERS; ++i) fds[i] = -1;
+
+#if defined(__linux__)
+    // Counters in one group are scheduled onto the PMU together, so every ratio between them (IPC, misses per
+    // instruction) comes from the same time slices. Cycles leads; events that can't join are counted on their own.
+    int leader = openCounter(PERF_CYCLES, -1, true);
+    if (leader >= 0) {
+        fds[PERF_CYCLES] = leader;
+        inGroup[PERF_CYCLES] = true;
+        groupSize = 1;
+        for (int i = PERF_CYCLES + 1; i < NUM_PERF_COUNTERS; ++i) {
+            fds[i] = openCounter(PerfCounterType(i), leader, true);
+            inGroup[i] = fds[i] >= 0;
+            groupSize += inGroup[i];
+        }
+
+        // A group with more events than the PMU has counters opens fine but never runs; fall back to standalone
+        // counters, which the kernel can multiplex
+        start();
+        volatile int spin = 0;
+        for (int i = 0; i < 100000; ++i) spin = spin + i;
+        if (!readGroup(nullptr)) {
+            for (int i = 0; i < NUM_PERF_COUNTERS; ++i) {
+                if (fds[i] >= 0) close(fds[i]);
+                fds[i] = -1;
+                inGroup[i] = false;
+            }
+            groupSize = 0;
+        }
+    }
+
+    for (int i = 0; i < NUM_PERF_COUNTERS; ++i) {
+        if (fds[i] < 0) fds[i] = openCounter(PerfCounterType(i), -1, false);
+    }
+#endif
+}
+
+PerfCounters::~PerfCounters()
+{
+#if defined(__linux__)
+    for (int fd : fds) {
+        if (fd >= 0) close(fd);
+    }
+#endif
+}
+
+bool PerfCounters::available() const
+{
+    for (int fd : fds) {
+        if (fd >= 0) return true;
+    }
+    return false;
+}
+
+void PerfCounters::start()
+{
+#if defined(__linux__)
+    if (groupSize > 0) {
+        ioctl(fds[PERF_CYCLES], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(fds[PERF_CYCLES], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+    for (int i = 0; i < NUM_PERF_COUNTERS; ++i) {
+        if (fds[i] < 0 || inGroup[i]) continue;
+        ioctl(fds[i], PERF_EVENT_IOC_RESET, 0);
+        ioctl(fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+    startTime = CycleTimer::currentSeconds();
+}
+
+bool PerfCounters::readGroup(PerfSample* sample)
+{
+#if defined(__linux__)
+    if (groupSize == 0) return false;
+    ioctl(fds[PERF_CYCLES], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    // Number of events, time enabled, time running, then one value per event in the order they joined
+    uint64_t data[3 + NUM_PERF_COUNTERS];
+    ssize_t bytes = (3 + groupSize) * sizeof(uint64_t);
+    if (read(fds[PERF_CYCLES], data, bytes) != bytes || data[0] != uint64_t(groupSize) || data[2] == 0) return false;
+
+    for (int i = 0, k = 0; sample && i < NUM_PERF_COUNTERS; ++i) {
+        if (!inGroup[i]) continue;
+        sample->values[i] = scaleCount(data[3 + k++], data[1], data[2]);
+        sample->valid[i] = true;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+PerfSample PerfCounters::stop()
+{
+    PerfSample sample;
+    sample.seconds = CycleTimer::currentSeconds() - startTime;
+    for (int i = 0; i < NUM_PERF_COUNTERS; ++i) {
+        sample.values[i] = 0;
+        sample.valid[i] = false;
+    }
+
+    readGroup(&sample);
+
+#if defined(__linux__)
+    for (int i = 0; i < NUM_PERF_COUNTERS; ++i) {
+        if (fds[i] < 0 || inGroup[i]) continue;
+        ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+
+        // value, time enabled, time running
+        uint64_t data[3];
+        if (read(fds[i], data, sizeof(data)) != sizeof(data) || data[2] == 0) continue;
+
+        sample.values[i] = scaleCount(data[0], data[1], data[2]);
+        sample.valid[i] = true;
+    }
+#endif
+
+    return sample;
+}
+
+double PerfSample::instructionsPerCycle() const
+{
+    if (!valid[PERF_CYCLES] || !valid[PERF_INSTRUCTIONS] || values[PERF_CYCLES] == 0) return 0;
+    return double(values[PERF_INSTRUCTIONS]) / values[PERF_CYCLES];
+}
+
+string PerfSample::report(uint64_t units, const char* unitName) const
+{
+    char buffer[128];
+    snprintf(buffer, sizeof(buffer), "%.2f ns/%s", 1e9 * seconds / max<uint64_t>(units, 1), unitName);
+    string text = buffer;
+
+    for (int i = 0; i < NUM_PERF_COUNTERS; ++i) {
+        if (valid[i]) {
+            snprintf(buffer, sizeof(buffer), ", %s %.3f/%s", perfCounterNames[i],
+                     double(values[i]) / max<uint64_t>(units, 1), unitName);
+        } else {
+            snprintf(buffer, sizeof(buffer), ", %s n/a", perfCounterNames[i]);
+        }
+        text += buffer;
+    }
+
+    if (instructionsPerCycle() > 0) {
+        snprintf(buffer, sizeof(buffer), ", IPC %.2f", instructionsPerCycle());
+        text += buffer;
+    }
+    if (valid[PERF_LLC_MISSES] && valid[PERF_L1D_MISSES] && values[PERF_L1D_MISSES] > 0) {
+        snprintf(buffer, sizeof(buffer), ", LLC/L1d miss ratio %.3f",
+                 double(values[PERF_LLC_MISSES]) / values[PERF_L1D_MISSES]);
+        text += buffer;
+    }
+    return text;
+}
@@ -1,12 +1,13 @@
 #include "rubiks_cube.h"
 
+#include "move_kernels.h"
+
 #include <cstdint>
 #include <string>
 #include <iostream>
 
 using namespace std;
 
-#define BITS_PER_COLOR 3
 #define NUM_SCRAMBLE_MOVES 30
 
 // Used for printing in color on terminal, see https://stackoverflow.com/a/3219471
@@ -18,30 +19,6 @@ using namespace std;
 #define TERM_COLOR_WHITE "\e[38;5;231m"
 #define TERM_COLOR_ORANGE "\e[38;5;208m"
 
-// Masking helpers for manipulating cube face bits
-const uint32_t MASK_N_BITS = 0xE;
-const uint32_t MASK_N_BITS_IDX_0 = MASK_N_BITS << (31 - BITS_PER_COLOR);
-const uint32_t MASK_N_BITS_IDX_1 = MASK_N_BITS_IDX_0 >> BITS_PER_COLOR;
-const uint32_t MASK_N_BITS_IDX_2 = MASK_N_BITS_IDX_1 >> BITS_PER_COLOR;
-const uint32_t MASK_N_BITS_IDX_3 = MASK_N_BITS_IDX_2 >> BITS_PER_COLOR;
-const uint32_t MASK_N_BITS_IDX_4 = MASK_N_BITS_IDX_3 >> BITS_PER_COLOR;
-const uint32_t MASK_N_BITS_IDX_5 = MASK_N_BITS_IDX_4 >> BITS_PER_COLOR;
-const uint32_t MASK_N_BITS_IDX_6 = MASK_N_BITS_IDX_5 >> BITS_PER_COLOR;
-const uint32_t MASK_N_BITS_IDX_7 = MASK_N_BITS_IDX_6 >> BITS_PER_COLOR;
-const uint32_t MASK_N_BITS_IDX_8 = MASK_N_BITS_IDX_7 >> BITS_PER_COLOR;
-
-const uint32_t TOP_MASK = 0xFF800000;
-const uint32_t NOT_TOP_MASK = ~TOP_MASK;
-
-const uint32_t BOTTOM_MASK = 0x3FE0;
-const uint32_t NOT_BOTTOM_MASK = ~BOTTOM_MASK;
-
-const uint32_t RIGHT_MASK = 0x381C0E0;
-const uint32_t NOT_RIGHT_MASK = ~RIGHT_MASK;
-
-const uint32_t LEFT_MASK = 0xE0703800;
-const uint32_t NOT_LEFT_MASK = ~LEFT_MASK;
-
 const uint32_t SOLVED_FACE_0 = 0b00000000000000000000000000000000;
 const uint32_t SOLVED_FACE_1 = 0b00100100100100100100100100100000;
 const uint32_t SOLVED_FACE_2 = 0b01001001001001001001001001000000;
@@ -59,18 +36,25 @@ const RubiksCube SOLVED_CUBE = RubiksCube();
 
 RubiksCube::RubiksCube() : data{SOLVED_FACE_0, SOLVED_FACE_1, SOLVED_FACE_2, SOLVED_FACE_3, SOLVED_FACE_4, SOLVED_FACE_5} {}
 
-bool RubiksCube::operator==(const RubiksCube& other)
+bool RubiksCube::operator==(const RubiksCube& other) const
 {
     for (int i = 0; i < 6; ++i) {
         if (data[i] != other.data[i]) {
-            printf("%d,   %d", data[i], other.data[i]);
             return false;
         }
     }
     return true;
 }
 
-bool RubiksCube::operator!=(const RubiksCube& other) { return !(*this == other); }
+bool RubiksCube::operator!=(const RubiksCube& other) const { return !(*this == other); }
+
+bool RubiksCube::operator<(const RubiksCube& other) const
+{
+    for (int i = 0; i < 6; ++i) {
+        if (data[i] != other.data[i]) return data[i] < other.data[i];
+    }
+    return false;
+}
 
 uint8_t RubiksCube::operator()(int face, int index) const
 {
@@ -78,35 +62,32 @@ uint8_t RubiksCube::operator()(int face, int index) const
     return (data[face] & mask) >> (32 - (index + 1) * BITS_PER_COLOR);
 }
 
+void RubiksCube::setFacelet(int face, int index, uint8_t color)
+{
+    uint32_t mask = MASK_N_BITS_IDX_0 >> (index * BITS_PER_COLOR);
+    data[face] = (data[face] & ~mask) | ((uint32_t(color) << (32 - (index + 1) * BITS_PER_COLOR)) & mask);
+}
+
+size_t RubiksCube::hash() const
+{
+    uint64_t h;
+    hashFaces<uint32_t, uint64_t>(data, h);
+    return h;
+}
+
 bool RubiksCube::isSolved()
 {
     return data[0] == SOLVED_FACE_0 && data[1] == SOLVED_FACE_1 && data[2] == SOLVED_FACE_2 &&
            data[3] == SOLVED_FACE_3 && data[4] == SOLVED_FACE_4 && data[5] == SOLVED_FACE_5;
 }
 
-inline uint64_t rotateFaceClockwise(uint32_t faceData)
+bool RubiksCube::satisfies(const CubeGoal& goal) const
 {
-    uint32_t rotatedFaceData = ((faceData << (6 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_0) |
-                                ((faceData << (2 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_1) |
-                                ((faceData >> (2 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_2) |
-                                ((faceData << (4 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_3) |
-                                (faceData & MASK_N_BITS_IDX_4) |
-                                ((faceData >> (4 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_5) |
-                                ((faceData << (2 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_6) |
-                                ((faceData >> (2 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_7) |
-                                ((faceData >> (6 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_8);
-
-    return rotatedFaceData;
-
-    /*
-    123
-    456
-    789
-
-    741
-    852
-    963
-    */
+    // Branch-free: accumulate the mismatching bits of every face and test once
+    uint32_t diff = ((data[0] & goal.mask[0]) ^ goal.pattern[0]) | ((data[1] & goal.mask[1]) ^ goal.pattern[1]) |
+                    ((data[2] & goal.mask[2]) ^ goal.pattern[2]) | ((data[3] & goal.mask[3]) ^ goal.pattern[3]) |
+                    ((data[4] & goal.mask[4]) ^ goal.pattern[4]) | ((data[5] & goal.mask[5]) ^ goal.pattern[5]);
+    return diff == 0;
 }
 
 void RubiksCube::scramble()
@@ -116,144 +97,62 @@ void RubiksCube::scramble()
     }
 }
 
-void RubiksCube::move(MoveType type)
+void RubiksCube::move(MoveType type) { applyMove<uint32_t>(data, type); }
+
+static CubeGeometry buildCubeGeometry()
 {
-    switch (type) {
-        case U1: {
-            // Rotate top face clockwise by 90 degrees
-            uint32_t rotatedTop = rotateFaceClockwise(data[0]);
-
-            uint32_t top1 = data[1] & TOP_MASK;
-            uint32_t top2 = data[2] & TOP_MASK;
-            uint32_t top3 = data[3] & TOP_MASK;
-            uint32_t top4 = data[4] & TOP_MASK;
-
-            data[1] = top2 | (data[1] & NOT_TOP_MASK);
-            data[2] = top3 | (data[2] & NOT_TOP_MASK);
-            data[3] = top4 | (data[3] & NOT_TOP_MASK);
-            data[4] = top1 | (data[4] & NOT_TOP_MASK);
-            data[0] = rotatedTop;
-
-            break;
-        }
-        case D1: {
-            // Rotate bottom face clockwise by 90 degrees
-            uint32_t rotatedBottom = rotateFaceClockwise(data[5]);
-
-            uint32_t bottom1 = data[1] & BOTTOM_MASK;
-            uint32_t bottom2 = data[2] & BOTTOM_MASK;
-            uint32_t bottom3 = data[3] & BOTTOM_MASK;
-            uint32_t bottom4 = data[4] & BOTTOM_MASK;
-
-            data[1] = bottom4 | (data[1] & NOT_BOTTOM_MASK);
-            data[2] = bottom1 | (data[2] & NOT_BOTTOM_MASK);
-            data[3] = bottom2 | (data[3] & NOT_BOTTOM_MASK);
-            data[4] = bottom3 | (data[4] & NOT_BOTTOM_MASK);
-            data[5] = rotatedBottom;
-
-            break;
-        }
-        case R1: {
-            // Rotate right face clockwise by 90 degrees
-            uint32_t rotatedRight = rotateFaceClockwise(data[3]);
-
-            uint32_t right0 = data[0] & RIGHT_MASK;
-            uint32_t right2 = data[2] & RIGHT_MASK;
-            uint32_t left4 = data[4] & LEFT_MASK;
-            uint32_t right5 = data[5] & RIGHT_MASK;
-
-            data[0] = right2 | (data[0] & NOT_RIGHT_MASK);
-            data[2] = right5 | (data[2] & NOT_RIGHT_MASK);
-            data[5] = (left4 >> BITS_PER_COLOR * 2) | (data[5] & NOT_RIGHT_MASK);
-            data[4] = (right0 << BITS_PER_COLOR * 2) | (data[4] & NOT_LEFT_MASK);
-            data[3] = rotatedRight;
-
-            break;
+    CubeGeometry geo;
+
+    // Trace each facelet through every move by marking it on an otherwise blank cube
+    for (int m = 0; m < 6; ++m) {
+        for (int p = 0; p < NUM_FACELETS; ++p) {
+            RubiksCube probe;
+            for (int q = 0; q < NUM_FACELETS; ++q) probe.setFacelet(q / FACELETS_PER_FACE, q % FACELETS_PER_FACE, 0);
+            probe.setFacelet(p / FACELETS_PER_FACE, p % FACELETS_PER_FACE, 1);
+            probe.move(availableMoves[m]);
+
+            for (int q = 0; q < NUM_FACELETS; ++q) {
+                if (probe(q / FACELETS_PER_FACE, q % FACELETS_PER_FACE) == 1) geo.movePerm[m][p] = q;
+            }
         }
-        case L1: {
-            // Rotate left face clockwise by 90 degrees
-            uint32_t rotatedLeft = rotateFaceClockwise(data[1]);
-
-            uint32_t left0 = data[0] & LEFT_MASK;
-            uint32_t left2 = data[2] & LEFT_MASK;
-            uint32_t right4 = data[4] & RIGHT_MASK;
-            uint32_t left5 = data[5] & LEFT_MASK;
-
-            data[0] = (right4 << BITS_PER_COLOR * 2) | (data[0] & NOT_LEFT_MASK);
-            data[2] = left0 | (data[2] & NOT_LEFT_MASK);
-            data[5] = left2 | (data[5] & NOT_LEFT_MASK);
-            data[4] = (left5 >> BITS_PER_COLOR * 2) | (data[4] & NOT_RIGHT_MASK);
-            data[1] = rotatedLeft;
-
-            break;
+    }
+
+    // Facelets on the same cubie are moved by exactly the same set of face turns (three for corners, two for edges)
+    int signature[NUM_FACELETS];
+    for (int p = 0; p < NUM_FACELETS; ++p) {
+        signature[p] = 0;
+        for (int m = 0; m < 6; ++m) {
+            if (geo.movePerm[m][p] != p) signature[p] |= 1 << m;
         }
-        case F1: {
-            // Rotate front face clockwise by 90 degrees
-            uint32_t rotatedFront = rotateFaceClockwise(data[2]);
-
-            uint32_t bottom0 = data[0] & BOTTOM_MASK;
-            uint32_t left3 = data[3] & LEFT_MASK;
-            uint32_t top5 = data[5] & TOP_MASK;
-            uint32_t right1 = data[1] & RIGHT_MASK;
-
-            uint32_t newBottom0 = ((right1 << (2 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_6) |
-                                    ((right1 >> (2 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_7) |
-                                    ((right1 >> (6 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_8);
-
-            uint32_t newLeft3 = ((bottom0 << (6 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_0) |
-                                ((bottom0 << (4 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_3) |
-                                ((bottom0 << (2 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_6);
-
-            uint32_t newTop5 = ((left3 << (6 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_0) |
-                                ((left3 << (2 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_1) |
-                                ((left3 >> (2 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_2);
-
-            uint32_t newRight1 = ((top5 >> (2 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_2) |
-                                    ((top5 >> (4 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_5) |
-                                    ((top5 >> (6 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_8);
-
-            data[0] = newBottom0 | (data[0] & NOT_BOTTOM_MASK);
-            data[3] = newLeft3 | (data[3] & NOT_LEFT_MASK);
-            data[5] = newTop5 | (data[5] & NOT_TOP_MASK);
-            data[1] = newRight1 | (data[1] & NOT_RIGHT_MASK);
-            data[2] = rotatedFront;
-
-            break;
+    }
+
+    int numSlots = 0;
+    for (int p = 0; p < NUM_FACELETS; ++p) {
+        geo.slotOf[p] = -1;
+        if (signature[p] == 0) continue;
+
+        for (int s = 0; s < numSlots; ++s) {
+            if (signature[geo.slotFacelets[s][0]] == signature[p]) {
+                geo.slotOf[p] = s;
+                geo.slotFacelets[s][geo.slotSize[s]++] = p;
+                break;
+            }
         }
-        case B1: {
-            // Rotate back face clockwise by 90 degrees
-            uint32_t rotatedBack = rotateFaceClockwise(data[4]);
-
-            uint32_t top0 = data[0] & TOP_MASK;
-            uint32_t right3 = data[3] & RIGHT_MASK;
-            uint32_t bottom5 = data[5] & BOTTOM_MASK;
-            uint32_t left1 = data[1] & LEFT_MASK;
-
-            uint32_t newTop0 = ((right3 << (2 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_0) |
-                                ((right3 << (4 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_1) |
-                                ((right3 << (6 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_2);
-
-            uint32_t newRight3 = ((bottom5 << (6 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_2) |
-                                    ((bottom5 << (2 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_5) |
-                                    ((bottom5 >> (2 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_8);
-
-            uint32_t newBottom5 = ((left1 >> (6 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_6) |
-                                    ((left1 >> (4 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_7) |
-                                    ((left1 >> (2 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_8);
-
-            uint32_t newLeft1 = ((top0 << (2 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_0) |
-                                ((top0 >> (2 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_3) |
-                                ((top0 >> (6 * BITS_PER_COLOR)) & MASK_N_BITS_IDX_6);
-
-            data[0] = newTop0 | (data[0] & NOT_TOP_MASK);
-            data[3] = newRight3 | (data[3] & NOT_RIGHT_MASK);
-            data[5] = newBottom5 | (data[5] & NOT_BOTTOM_MASK);
-            data[1] = newLeft1 | (data[1] & NOT_LEFT_MASK);
-            data[4] = rotatedBack;
-
-            break;
+        if (geo.slotOf[p] == -1) {
+            geo.slotOf[p] = numSlots;
+            geo.slotSize[numSlots] = 1;
+            geo.slotFacelets[numSlots][0] = p;
+            ++numSlots;
         }
     }
+
+    return geo;
+}
+
+const CubeGeometry& cubeGeometry()
+{
+    static const CubeGeometry geo = buildCubeGeometry();
+    return geo;
 }
 
 // struct RubiksCube {
@@ -0,0 +1,199 @@
+#include "solution_cache.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+#define SNAPSHOT_MAGIC 0x43535243  // "RCSC"
+#define SNAPSHOT_VERSION 1
+
+// Rough per-entry cost of the slot and index node (the key is stored in both) on top of the stored moves
+const size_t ENTRY_OVERHEAD = 2 * sizeof(RubiksCube) + sizeof(size_t) + 6 * sizeof(void*);
+
+// Snapshot entries store the move count in one byte
+const size_t MAX_CACHED_MOVES = 255;
+
+static size_t entryBytes(size_t numMoves) { return ENTRY_OVERHEAD + numMoves; }
+
+SolutionCache::SolutionCache(size_t maxBytes, int numShards, bool useInverse)
+    : shardBudget(maxBytes / numShards), useInverse(useInverse)
+{
+    for (int i = 0; i < numShards; ++i) shards.push_back(make_unique<Shard>());
+}
+
+SolutionCache::Shard& SolutionCache::shardFor(const RubiksCube& key) const
+{
+    // The index hashes the low bits, so pick shards with the high ones
+    return *shards[(key.hash() >> 40) % shards.size()];
+}
+
+bool SolutionCache::lookup(const RubiksCube& cube, vector<MoveType>& solution)
+{
+    CanonicalForm form = canonicalize(cube, useInverse);
+    Shard& shard = shardFor(form.cube);
+
+    vector<MoveType> canonical;
+    {
+        lock_guard<mutex> guard(shard.lock);
+        auto it = shard.index.find(form.cube);
+        if (it == shard.index.end()) {
+            ++misses;
+            return false;
+        }
+
+        Entry& entry = shard.slots[it->second];
+        entry.referenced = true;
+        for (uint8_t m : entry.moves) canonical.push_back(availableMoves[m]);
+    }
+
+    ++hits;
+    solution = mapSolution(canonical, form);
+    return true;
+}
+
+void SolutionCache::insert(const RubiksCube& cube, const vector<MoveType>& solution)
+{
+    CanonicalForm form = canonicalize(cube, useInverse);
+
+    vector<uint8_t> moves;
+    for (auto m : canonicalSolution(solution, form)) moves.push_back(m);
+    insertCanonical(form.cube, moves);
+}
+
+void SolutionCache::insertCanonical(const RubiksCube& key, const vector<uint8_t>& moves)
+{
+    Shard& shard = shardFor(key);
+    lock_guard<mutex> guard(shard.lock);
+
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+        // Keep whichever solution is shorter
+        Entry& entry = shard.slots[it->second];
+        if (moves.size() < entry.moves.size()) {
+            shard.bytes -= entry.moves.size() - moves.size();
+            entry.moves = moves;
+        }
+        entry.referenced = true;
+        return;
+    }
+
+    size_t bytes = entryBytes(moves.size());
+    if (bytes > shardBudget || moves.size() > MAX_CACHED_MOVES) return;
+    while (shard.bytes + bytes > shardBudget) evict(shard);
+
+    size_t slot;
+    if (!shard.freeSlots.empty()) {
+        slot = shard.freeSlots.back();
+        shard.freeSlots.pop_back();
+    } else {
+        slot = shard.slots.size();
+        shard.slots.emplace_back();
+    }
+
+    // New entries start unreferenced so a burst of one-off inserts can't flush entries that are being hit
+    shard.slots[slot] = {key, moves, false, true};
+    shard.index[key] = slot;
+    shard.bytes += bytes;
+    ++inserts;
+}
+
+void SolutionCache::evict(Shard& shard)
+{
+    // CLOCK: sweep the hand, giving referenced entries a second chance
+    while (true) {
+        if (shard.hand >= shard.slots.size()) shard.hand = 0;
+        Entry& entry = shard.slots[shard.hand++];
+        if (!entry.occupied) continue;
+
+        if (entry.referenced) {
+            entry.referenced = false;
+            continue;
+        }
+
+        shard.index.erase(entry.key);
+        shard.bytes -= entryBytes(entry.moves.size());
+        shard.freeSlots.push_back(shard.hand - 1);
+        entry.occupied = false;
+        entry.moves.clear();
+        entry.moves.shrink_to_fit();
+        ++evictions;
+        return;
+    }
+}
+
+SolutionCacheStats SolutionCache::stats() const
+{
+    SolutionCacheStats result = {hits, misses, inserts, evictions, 0, 0};
+    for (auto& shard : shards) {
+        lock_guard<mutex> guard(shard->lock);
+        result.entries += shard->index.size();
+        result.bytes += shard->bytes;
+    }
+    return result;
+}
+
+bool SolutionCache::saveSnapshot(const char* path) const
+{
+    FILE* fp = fopen(path, "wb");
+    if (!fp) return false;
+
+    uint32_t header[2] = {SNAPSHOT_MAGIC, SNAPSHOT_VERSION};
+    bool ok = fwrite(header, sizeof(header), 1, fp) == 1;
+
+    for (auto& shard : shards) {
+        lock_guard<mutex> guard(shard->lock);
+        for (const Entry& entry : shard->slots) {
+            if (!entry.occupied) continue;
+
+            uint8_t length = entry.moves.size();
+            ok = ok && fwrite(entry.key.faces(), sizeof(uint32_t), 6, fp) == 6;
+            ok = ok && fwrite(&length, 1, 1, fp) == 1;
+            ok = ok && fwrite(entry.moves.data(), 1, length, fp) == length;
+        }
+    }
+
+    return fclose(fp) == 0 && ok;
+}
+
+bool SolutionCache::loadSnapshot(const char* path)
+{
+    FILE* fp = fopen(path, "rb");
+    if (!fp) return false;
+
+    uint32_t header[2];
+    if (fread(header, sizeof(header), 1, fp) != 1 || header[0] != SNAPSHOT_MAGIC || header[1] != SNAPSHOT_VERSION) {
+        fclose(fp);
+        return false;
+    }
+
+    // Read and check every record before inserting any, so a corrupt or truncated file leaves the cache unchanged
+    vector<pair<RubiksCube, vector<uint8_t>>> records;
+    uint32_t faces[6];
+    uint8_t length;
+    bool ok = true;
+    size_t read;
+    while (ok && (read = fread(faces, sizeof(uint32_t), 6, fp)) != 0) {
+        ok = read == 6 && fread(&length, 1, 1, fp) == 1;
+        if (!ok) break;
+
+        RubiksCube cube(faces);
+        for (int f = 0; ok && f < NUM_FACES; ++f) ok = (faces[f] & 0x1F) == 0 && cube(f, 4) == f;
+
+        vector<uint8_t> moves(length);
+        ok = ok && fread(moves.data(), 1, length, fp) == length;
+        for (uint8_t m : moves) ok = ok && m < 6;
+
+        if (ok) records.emplace_back(cube, moves);
+    }
+
+    ok = ok && !ferror(fp);
+    fclose(fp);
+    if (!ok) return false;
+
+    for (auto& record : records) insertCanonical(record.first, record.second);
+    return true;
+}
@@ -0,0 +1,323 @@
+#include "solver.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "expand_node.h"
+#include "move_kernels.h"
+
+using namespace std;
+
+// The lockstep search is compiled for AVX2, where one LaneWord fills a register, and only runs on CPUs that have it.
+// Everything crossing into it is passed by pointer or reference, so no vector ever goes through the baseline ABI.
+#if defined(__x86_64__) || defined(__i386__)
+#define LOCKSTEP_TARGET __attribute__((target("avx2")))
+static bool haveLockstep() { return __builtin_cpu_supports("avx2"); }
+#else
+#define LOCKSTEP_TARGET
+static bool haveLockstep() { return true; }
+#endif
+
+// One face of every lane; the move kernels work on it unchanged through GCC/Clang vector extensions. The alignment is
+// spelled out because a vector's natural alignment depends on the instruction set, and the baseline code that
+// allocates the lanes must agree with the AVX2 code that reads them.
+typedef uint32_t LaneWord
+    __attribute__((vector_size(BATCH_LANES * sizeof(uint32_t)), aligned(BATCH_LANES * sizeof(uint32_t))));
+typedef uint64_t LaneHash __attribute__((vector_size(BATCH_LANES * sizeof(uint64_t))));
+
+struct LaneCubes {
+    LaneWord faces[6];
+};
+
+struct BatchSearch {
+    const EndgameTable& endgame;
+    int prefixLength;            // moves before the level whose children are probed: bound - depth() - 1
+    vector<MoveType> path;       // the prefix every lane is at
+    vector<int> runs;            // runs[d]: copies of path[d] at the end of path[0..d]
+    vector<LaneCubes> stack;     // stack[d]: every lane's cube after path[0..d)
+    int cube[BATCH_LANES];       // index of the cube in each lane
+    uint64_t left[BATCH_LANES];  // prefixes the lane hasn't probed yet
+    const vector<RubiksCube>& cubes;
+    vector<vector<MoveType>>& solutions;
+    SearchStats& stats;
+};
+
+static bool searchSolve(const RubiksCube& cube, const EndgameTable& endgame, int depth, int bound, MoveType prev,
+                        int run, vector<MoveType>& path, SearchStats& stats)
+{
+    int remaining = bound - depth;
+    if (remaining <= endgame.depth()) {
+        // Anything this close to solved is in the table, so a miss or a longer distance prunes the subtree
+        int distance;
+        MoveType next;
+        ++stats.endgameProbes;
+        if (!endgame.probe(cube, distance, next) || distance > remaining) return false;
+        return endgame.appendSolution(cube, path);
+    }
+
+    ++stats.nodesExpanded;
+    ChildNode children[MAX_CHILDREN];
+
+    if (remaining - 1 <= endgame.depth()) {
+        // Every child finishes with a probe: do them all at once so their misses overlap, and only visit the ones
+        // within range
+        int generated;
+        int n = expandNode(cube, prev, run, endgame, remaining - 1, children, &generated);
+        stats.endgameProbes += generated;
+
+        for (int i = 0; i < n; ++i) {
+            path.push_back(children[i].move);
+            if (endgame.appendSolution(children[i].cube, path)) return true;
+            path.pop_back();
+        }
+        return false;
+    }
+
+    int n = generateChildren(cube, prev, run, children);
+    for (int i = 0; i < n; ++i) {
+        path.push_back(children[i].move);
+        if (searchSolve(children[i].cube, endgame, depth + 1, bound, children[i].move, children[i].run, path, stats)) {
+            return true;
+        }
+        path.pop_back();
+    }
+
+    return false;
+}
+
+bool solveCube(const RubiksCube& cube, const EndgameTable& endgame, int maxDepth, vector<MoveType>& solution,
+               SearchStats* stats)
+{
+    SearchStats local;
+    SearchStats& counters = stats ? *stats : local;
+
+    // Bounds up to the table depth are all answered by the first probe
+    solution.clear();
+    for (int bound = min(endgame.depth(), maxDepth); bound <= maxDepth; ++bound) {
+        if (searchSolve(cube, endgame, 0, bound, U1, 0, solution, counters)) return true;
+    }
+    return false;
+}
+
+// Number of move sequences of a given length that the searches don't prune as redundant
+static uint64_t countPrefixes(int length)
+{
+    // Sequences by their last move and how many times it repeats at the end
+    uint64_t count[6][4] = {}, next[6][4];
+    count[U1][0] = 1;
+    for (int d = 0; d < length; ++d) {
+        for (auto& row : next) {
+            for (auto& ways : row) ways = 0;
+        }
+        for (auto prev : availableMoves) {
+            for (int run = 0; run < 4; ++run) {
+                if (!count[prev][run]) continue;
+                for (auto m : availableMoves) {
+                    if (!isRedundantMove(prev, run, m)) next[m][m == prev ? run + 1 : 1] += count[prev][run];
+                }
+            }
+        }
+        for (int m = 0; m < 6; ++m) {
+            for (int run = 0; run < 4; ++run) count[m][run] = next[m][run];
+        }
+    }
+
+    uint64_t total = 0;
+    for (auto& row : count) {
+        for (auto ways : row) total += ways;
+    }
+    return total;
+}
+
+static MoveType prefixMove(const BatchSearch& search, int depth) { return depth ? search.path[depth - 1] : U1; }
+static int prefixRun(const BatchSearch& search, int depth) { return depth ? search.runs[depth - 1] : 0; }
+
+static void setPrefixMove(BatchSearch& search, int depth, MoveType m)
+{
+    search.path[depth] = m;
+    search.runs[depth] = m == prefixMove(search, depth) ? prefixRun(search, depth) + 1 : 1;
+}
+
+// Fill the prefix from depth on with the first moves the search takes
+static void firstPrefix(BatchSearch& search, int depth)
+{
+    for (int d = depth; d < search.prefixLength; ++d) {
+        int i = 0;
+        while (isRedundantMove(prefixMove(search, d), prefixRun(search, d), availableMoves[i])) ++i;
+        setPrefixMove(search, d, availableMoves[i]);
+    }
+}
+
+// Step to the next prefix in depth-first order, wrapping around from the last to the first. Returns the depth of the
+// first move that changed.
+static int nextPrefix(BatchSearch& search)
+{
+    for (int d = search.prefixLength - 1; d >= 0; --d) {
+        for (int i = search.path[d] + 1; i < 6; ++i) {
+            if (isRedundantMove(prefixMove(search, d), prefixRun(search, d), availableMoves[i])) continue;
+            setPrefixMove(search, d, availableMoves[i]);
+            firstPrefix(search, d + 1);
+            return d;
+        }
+    }
+    firstPrefix(search, 0);
+    return 0;
+}
+
+LOCKSTEP_TARGET __attribute__((flatten)) static void moveLanes(LaneCubes& lanes, MoveType m)
+{
+    applyMove<LaneWord>(lanes.faces, m);
+}
+
+LOCKSTEP_TARGET __attribute__((flatten)) static void hashLanes(const LaneCubes& lanes, LaneHash& hashes)
+{
+    hashFaces<LaneWord, LaneHash>(lanes.faces, hashes);
+}
+
+// Put cube into lane at the current prefix: it starts probing here and wraps around until it has seen every prefix
+LOCKSTEP_TARGET static void joinLane(BatchSearch& search, int lane, int index, uint64_t prefixes)
+{
+    RubiksCube cube = search.cubes[index];
+    for (int d = 0; d <= search.prefixLength; ++d) {
+        if (d) cube.move(search.path[d - 1]);
+        for (int i = 0; i < 6; ++i) search.stack[d].faces[i][lane] = cube.faces()[i];
+    }
+    search.cube[lane] = index;
+    search.left[lane] = prefixes;
+}
+
+// Probe every child of the current prefix for the lanes in active and return the lanes that found their solution.
+// All slots are hashed together and prefetched before any entry is read, like expandNode() does for one cube.
+LOCKSTEP_TARGET static uint32_t probeChildren(BatchSearch& search, uint32_t active)
+{
+    const EndgameTable& endgame = search.endgame;
+    MoveType prev = prefixMove(search, search.prefixLength);
+    int run = prefixRun(search, search.prefixLength);
+
+    LaneCubes children[6];
+    size_t slots[6][BATCH_LANES];
+    for (auto m : availableMoves) {
+        if (isRedundantMove(prev, run, m)) continue;
+
+        children[m] = search.stack[search.prefixLength];
+        moveLanes(children[m], m);
+
+        LaneHash hashes;
+        hashLanes(children[m], hashes);
+        for (uint32_t rest = active; rest; rest &= rest - 1) {
+            int lane = __builtin_ctz(rest);
+            slots[m][lane] = endgame.slotOfHash(hashes[lane]);
+            endgame.prefetchSlot(slots[m][lane]);
+        }
+        search.stats.endgameProbes += __builtin_popcount(active);
+    }
+
+    uint32_t solved = 0;
+    for (auto m : availableMoves) {
+        if (isRedundantMove(prev, run, m)) continue;
+
+        const uint32_t* faces = reinterpret_cast<const uint32_t*>(children[m].faces);
+        uint32_t found = endgame.findLanes(faces, BATCH_LANES, slots[m], active & ~solved);
+        for (; found; found &= found - 1) {
+            int lane = __builtin_ctz(found);
+            uint32_t cube[6];
+            for (int i = 0; i < 6; ++i) cube[i] = children[m].faces[i][lane];
+
+            // Every cube left at this bound is further than the table reaches, so any stored child ends a solution
+            vector<MoveType> solution(search.path);
+            solution.push_back(m);
+            if (endgame.appendSolution(RubiksCube(cube), solution)) {
+                search.solutions[search.cube[lane]].swap(solution);
+                solved |= 1u << lane;
+            }
+        }
+    }
+    return solved;
+}
+
+// One IDA* bound for every cube in pending; returns the cubes still unsolved
+LOCKSTEP_TARGET static vector<int> searchBound(BatchSearch& search, int bound, const vector<int>& pending,
+                                               vector<bool>& solved)
+{
+    search.prefixLength = bound - search.endgame.depth() - 1;
+    search.path.assign(search.prefixLength, U1);
+    search.runs.assign(search.prefixLength, 0);
+    search.stack.resize(search.prefixLength + 1);
+    firstPrefix(search, 0);
+    uint64_t prefixes = countPrefixes(search.prefixLength);
+
+    vector<int> unsolved;
+    size_t queued = 0;
+    uint32_t active = 0;
+    for (;;) {
+        for (int lane = 0; lane < BATCH_LANES && queued < pending.size(); ++lane) {
+            if (active & (1u << lane)) continue;
+            joinLane(search, lane, pending[queued++], prefixes);
+            active |= 1u << lane;
+        }
+        if (!active) break;
+
+        ++search.stats.nodesExpanded;
+        uint32_t done = probeChildren(search, active);
+        for (uint32_t rest = done; rest; rest &= rest - 1) solved[search.cube[__builtin_ctz(rest)]] = true;
+        for (uint32_t rest = active & ~done; rest; rest &= rest - 1) {
+            int lane = __builtin_ctz(rest);
+            if (--search.left[lane] > 0) continue;
+            unsolved.push_back(search.cube[lane]);
+            done |= 1u << lane;
+        }
+
+        // Lanes that finished are refilled from the queue at the next prefix
+        active &= ~done;
+        if (!active && queued == pending.size()) break;
+
+        for (int d = nextPrefix(search); d < search.prefixLength; ++d) {
+            search.stack[d + 1] = search.stack[d];
+            moveLanes(search.stack[d + 1], search.path[d]);
+            ++search.stats.nodesExpanded;
+        }
+    }
+    return unsolved;
+}
+
+LOCKSTEP_TARGET static int solveLockstep(const vector<RubiksCube>& cubes, const EndgameTable& endgame, int maxDepth,
+                                         vector<vector<MoveType>>& solutions, vector<bool>& solved,
+                                         SearchStats& stats)
+{
+    BatchSearch search = {endgame, 0, {}, {}, {}, {}, {}, cubes, solutions, stats};
+
+    // Bounds up to the table depth are all answered by probing the cube itself
+    int firstBound = min(endgame.depth(), maxDepth);
+    vector<int> pending;
+    for (size_t i = 0; i < cubes.size(); ++i) {
+        int distance;
+        MoveType next;
+        ++stats.endgameProbes;
+        solved[i] = endgame.probe(cubes[i], distance, next) && distance <= firstBound &&
+                    endgame.appendSolution(cubes[i], solutions[i]);
+        if (!solved[i]) pending.push_back(i);
+    }
+
+    for (int bound = firstBound + 1; bound <= maxDepth && !pending.empty(); ++bound) {
+        pending = searchBound(search, bound, pending, solved);
+    }
+    return cubes.size() - pending.size();
+}
+
+int solveCubeBatch(const vector<RubiksCube>& cubes, const EndgameTable& endgame, int maxDepth,
+                   vector<vector<MoveType>>& solutions, vector<bool>& solved, SearchStats* stats)
+{
+    SearchStats local;
+    SearchStats& counters = stats ? *stats : local;
+
+    solutions.assign(cubes.size(), {});
+    solved.assign(cubes.size(), false);
+    if (haveLockstep()) return solveLockstep(cubes, endgame, maxDepth, solutions, solved, counters);
+
+    int numSolved = 0;
+    for (size_t i = 0; i < cubes.size(); ++i) {
+        solved[i] = solveCube(cubes[i], endgame, maxDepth, solutions[i], &counters);
+        numSolved += solved[i];
+    }
+    return numSolved;
+}
@@ -0,0 +1,129 @@
+#include <cassert>
+#include <iostream>
+
+#include "cube_goal.h"
+#include "cycle_timer.h"
+#include "rubiks_cube.h"
+
+using namespace std;
+
+int main(int argc, char **argv) {
+    srand(time(0));
+
+    // TEST: facelet geometry has 8 corners and 12 edges
+    printf(">>>>>>>> Cube Geometry\n");
+    const CubeGeometry& geo = cubeGeometry();
+    int corners = 0, edges = 0;
+    for (int s = 0; s < NUM_CUBIE_SLOTS; ++s) {
+        if (geo.slotSize[s] == 3) ++corners;
+        if (geo.slotSize[s] == 2) ++edges;
+    }
+    assert(corners == 8 && edges == 12 && "Expected 8 corner and 12 edge slots");
+
+    // TEST: scrambling only permutes whole cubies, so every slot holds the colors of some solved cubie
+    for (int i = 0; i < 100; ++i) {
+        RubiksCube cube;
+        cube.scramble();
+
+        int solvedColors = 0, scrambledColors = 0;
+        for (int s = 0; s < NUM_CUBIE_SLOTS; ++s) {
+            int colors = 0;
+            for (int j = 0; j < geo.slotSize[s]; ++j) colors |= 1 << cube(geo.slotFacelets[s][j] / 9, geo.slotFacelets[s][j] % 9);
+            assert(__builtin_popcount(colors) == geo.slotSize[s] && "Cubie shows the same color twice");
+            scrambledColors += colors;
+
+            colors = 0;
+            for (int j = 0; j < geo.slotSize[s]; ++j) colors |= 1 << (geo.slotFacelets[s][j] / 9);
+            solvedColors += colors;
+        }
+        assert(solvedColors == scrambledColors);
+    }
+
+    // TEST: opposite faces commute, which the move pruning in the searches relies on
+    for (int axis = 0; axis < 3; ++axis) {
+        RubiksCube a, b;
+        a.scramble();
+        b = a;
+        a.move(availableMoves[2 * axis]);
+        a.move(availableMoves[2 * axis + 1]);
+        b.move(availableMoves[2 * axis + 1]);
+        b.move(availableMoves[2 * axis]);
+        assert(a == b && "Opposite face moves do not commute");
+    }
+
+    // TEST: goals hold on the solved cube and only look at their own facelets
+    printf(">>>>>>>> Goal Masks\n");
+    CubeGoal cross = crossGoal(0);
+    CubeGoal block = blockGoal(0, 1, 2);
+    CubeGoal oll = orientLastLayerGoal(5);
+    assert(SOLVED_CUBE.satisfies(cross) && SOLVED_CUBE.satisfies(block) && SOLVED_CUBE.satisfies(oll));
+    assert(SOLVED_CUBE.satisfies(firstTwoLayersGoal(0)));
+
+    RubiksCube cube;
+    cube.move(D1);
+    assert(cube.satisfies(cross) && "Turning the opposite face must not break the cross");
+    assert(cube.satisfies(oll) && "Turning the last layer keeps it oriented");
+    cube.move(F1);
+    assert(!cube.satisfies(cross) && "Turning a side face breaks the cross");
+
+    // TEST: solve the cross of scrambled cubes and check the table distance matches the solution length
+    printf(">>>>>>>> Cross Solving\n");
+    double startTime = CycleTimer::currentSeconds();
+    GoalPruningTable crossTable(cross, 8);
+    double buildTime = CycleTimer::currentSeconds() - startTime;
+    cout << "Built cross table with " << crossTable.size() << " entries in " << buildTime << " s" << endl;
+    assert(ChunkPool::local().allocated() == 0 && "Table build kept its frontier chunks in the thread's pool");
+
+    for (int i = 0; i < 20; ++i) {
+        cube = RubiksCube();
+        int scrambleLength = 1 + rand() % 4;
+        for (int j = 0; j < scrambleLength; ++j) cube.move(availableMoves[rand() % 6]);
+
+        vector<MoveType> solution;
+        [[maybe_unused]] bool found = solveGoal(cube, crossTable, 20, solution);
+        assert(found);
+        assert((int)solution.size() <= 3 * scrambleLength && "Cross solution is longer than undoing the scramble");
+        if (solution.size() <= 8) assert((int)solution.size() == crossTable.lowerBound(cube) && "Table distance is not exact");
+        for (auto m : solution) cube.move(m);
+        assert(cube.satisfies(cross));
+    }
+
+    startTime = CycleTimer::currentSeconds();
+    const int NUM_SOLVES = 100;
+    for (int i = 0; i < NUM_SOLVES; ++i) {
+        cube = RubiksCube();
+        cube.scramble();
+
+        vector<MoveType> solution;
+        [[maybe_unused]] bool found = solveGoal(cube, crossTable, 20, solution);
+        assert(found);
+        for (auto m : solution) cube.move(m);
+        assert(cube.satisfies(cross));
+    }
+    double duration = CycleTimer::currentSeconds() - startTime;
+    cout << "Average time per cross solve " << 1e6 * duration / NUM_SOLVES << " us" << endl;
+
+    // TEST: last-layer orientation and 2x2x2 block with depth-limited tables
+    printf(">>>>>>>> Block and Orientation Solving\n");
+    GoalPruningTable blockTable(block, 6);
+    GoalPruningTable ollTable(oll, 5);
+    for (int i = 0; i < 5; ++i) {
+        cube = RubiksCube();
+        for (int j = 0; j < 2; ++j) cube.move(availableMoves[rand() % 6]);
+
+        vector<MoveType> solution;
+        RubiksCube copy = cube;
+        [[maybe_unused]] bool found = solveGoal(copy, blockTable, 6, solution);
+        assert(found && solution.size() <= 6);
+        for (auto m : solution) copy.move(m);
+        assert(copy.satisfies(block));
+
+        copy = cube;
+        found = solveGoal(copy, ollTable, 6, solution);
+        assert(found && solution.size() <= 6);
+        for (auto m : solution) copy.move(m);
+        assert(copy.satisfies(oll));
+    }
+
+    return 0;
+}
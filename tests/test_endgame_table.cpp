@@ -0,0 +1,271 @@
+#include <cassert>
+#include <cstdio>
+#include <iostream>
+
+#include "cycle_timer.h"
+#include "endgame_table.h"
+#include "expand_node.h"
+#include "frontier_pool.h"
+#include "perf_counters.h"
+#include "rubiks_cube.h"
+#include "solver.h"
+
+using namespace std;
+
+int main(int argc, char **argv) {
+    srand(time(0));
+
+    // TEST: build the table and check distances near solved
+    printf(">>>>>>>> Endgame Table Build\n");
+    const int DEPTH = 7;
+    double startTime = CycleTimer::currentSeconds();
+    EndgameTable table(DEPTH);
+    double duration = CycleTimer::currentSeconds() - startTime;
+    cout << "Built depth " << DEPTH << " table with " << table.size() << " states in " << duration << " s" << endl;
+    assert(ChunkPool::local().allocated() == 0 && "Table build kept its frontier chunks in the thread's pool");
+
+    int distance;
+    MoveType next;
+    assert(table.probe(SOLVED_CUBE, distance, next) && distance == 0);
+    for (auto m : availableMoves) {
+        RubiksCube cube;
+        cube.move(m);
+        assert(table.probe(cube, distance, next) && distance == 3 && next == m);
+
+        cube = RubiksCube();
+        cube.move(m);
+        cube.move(m);
+        cube.move(m);
+        assert(table.probe(cube, distance, next) && distance == 1 && next == m);
+    }
+
+    // TEST: following the table solves every stored state in exactly its distance
+    printf(">>>>>>>> Endgame Table Solutions\n");
+    for (int i = 0; i < 1000; ++i) {
+        RubiksCube cube;
+        for (int j = 0; j < 2; ++j) cube.move(availableMoves[rand() % 6]);
+
+        vector<MoveType> solution;
+        [[maybe_unused]] bool found = table.probe(cube, distance, next);
+        [[maybe_unused]] bool followed = table.appendSolution(cube, solution);
+        assert(found && followed && (int)solution.size() == distance);
+        for (auto m : solution) cube.move(m);
+        assert(cube.isSolved());
+    }
+
+    // TEST: mmap round trip
+    printf(">>>>>>>> Endgame Table mmap\n");
+    const char* path = "endgame_table.bin";
+    [[maybe_unused]] bool saved = table.save(path);
+    assert(saved);
+    unique_ptr<EndgameTable> mapped = EndgameTable::load(path);
+    assert(mapped && mapped->size() == table.size() && mapped->depth() == DEPTH);
+    for (int i = 0; i < 1000; ++i) {
+        RubiksCube cube;
+        for (int j = 0; j < 3; ++j) cube.move(availableMoves[rand() % 6]);
+
+        [[maybe_unused]] int mappedDistance;
+        [[maybe_unused]] MoveType mappedNext;
+        [[maybe_unused]] bool found = table.probe(cube, distance, next);
+        [[maybe_unused]] bool mappedFound = mapped->probe(cube, mappedDistance, mappedNext);
+        assert(found == mappedFound);
+        assert(!found || (distance == mappedDistance && next == mappedNext));
+    }
+    remove(path);
+    assert(!EndgameTable::load(path));
+
+    // TEST: images with a wrong count, no empty slot or out of range fields are rejected
+    vector<uint32_t> image(table.imageBytes() / sizeof(uint32_t));
+    table.writeImage(image.data());
+    const size_t HEADER_WORDS = 8, ENTRY_WORDS = 6;
+    uint64_t* header = reinterpret_cast<uint64_t*>(image.data());
+    uint32_t* entries = image.data() + HEADER_WORDS;
+    uint64_t capacity = header[2];
+    auto entryOf = [&](const RubiksCube& cube) {
+        for (uint64_t slot = 0; slot < capacity; ++slot) {
+            bool match = entries[slot * ENTRY_WORDS + 1] != 0;
+            for (int i = 0; i < 6; ++i) {
+                match = match && (entries[slot * ENTRY_WORDS + i] & 0xFFFFFFE0) == cube.faces()[i];
+            }
+            if (match) return entries + slot * ENTRY_WORDS;
+        }
+        return (uint32_t*)nullptr;
+    };
+    assert(EndgameTable::fromImage(image.data(), table.imageBytes()));
+
+    header[3] = capacity;
+    assert(!EndgameTable::fromImage(image.data(), table.imageBytes()) && "Table with no empty slot was accepted");
+    header[3] = table.size() + 1;
+    assert(!EndgameTable::fromImage(image.data(), table.imageBytes()) && "Wrong entry count was accepted");
+    header[3] = table.size();
+    header[2] = 1ull << 62;
+    assert(!EndgameTable::fromImage(image.data(), HEADER_WORDS * sizeof(uint32_t)) &&
+           "Capacity whose size wraps around was accepted");
+    header[2] = capacity;
+
+    RubiksCube oneAway;
+    oneAway.move(U1);
+    oneAway.move(U1);
+    oneAway.move(U1);
+    uint32_t* entry = entryOf(oneAway);
+    assert(entry && (entry[1] & 0x1F) == U1);
+    entry[1] |= 0x1F;
+    assert(!EndgameTable::fromImage(image.data(), table.imageBytes()) && "Next move out of range was accepted");
+    entry[1] = (entry[1] & 0xFFFFFFE0) | U1;
+    entry[0] |= 0x1F;
+    assert(!EndgameTable::fromImage(image.data(), table.imageBytes()) && "Distance beyond the depth was accepted");
+
+    // TEST: a broken chain of next moves ends the solution instead of looping
+    entry[0] = (entry[0] & 0xFFFFFFE0) | 2;
+    unique_ptr<EndgameTable> broken = EndgameTable::fromImage(image.data(), table.imageBytes());
+    assert(broken);
+    RubiksCube twoAway;
+    twoAway.move(U1);
+    twoAway.move(U1);
+    vector<MoveType> partial = {D1};
+    [[maybe_unused]] bool followed = broken->appendSolution(twoAway, partial);
+    assert(!followed && partial.size() == 1 && "Broken chain gave a solution");
+
+    // TEST: IDA* finishing with endgame probes matches the table's distance and solves deeper scrambles
+    printf(">>>>>>>> Search with Endgame Probes\n");
+    for (int i = 0; i < 20; ++i) {
+        RubiksCube cube;
+        for (int j = 0; j < 4; ++j) cube.move(availableMoves[rand() % 6]);
+
+        vector<MoveType> solution;
+        SearchStats stats;
+        startTime = CycleTimer::currentSeconds();
+        [[maybe_unused]] bool solvedCube = solveCube(cube, table, 14, solution, &stats);
+        duration = CycleTimer::currentSeconds() - startTime;
+        assert(solvedCube && solution.size() <= 12);
+
+        if (table.probe(cube, distance, next)) assert((int)solution.size() == distance);
+        for (auto m : solution) cube.move(m);
+        assert(cube.isSolved());
+
+        if (i < 5) {
+            cout << solution.size() << " move solution, " << stats.nodesExpanded << " nodes, " << stats.endgameProbes
+                 << " probes, " << 1e3 * duration << " ms" << endl;
+        }
+    }
+
+    // TEST: pipelined expansion keeps exactly the children a probe would keep, best first
+    printf(">>>>>>>> Pipelined Node Expansion\n");
+    const int NUM_NODES = 20000;
+    vector<RubiksCube> nodes(NUM_NODES);
+    for (auto& node : nodes) {
+        for (int j = 0; j < 5; ++j) node.move(availableMoves[rand() % 6]);
+    }
+
+    for (int i = 0; i < 200; ++i) {
+        MoveType prev = availableMoves[rand() % 6];
+        int run = rand() % 4;
+        int budget = 3 + rand() % (DEPTH - 2);
+
+        ChildNode all[MAX_CHILDREN], kept[MAX_CHILDREN];
+        int generated;
+        int n = generateChildren(nodes[i], prev, run, all);
+        int k = expandNode(nodes[i], prev, run, table, budget, kept, &generated);
+        assert(generated == n && k <= n);
+
+        int expected = 0;
+        for (int c = 0; c < n; ++c) {
+            int bound = table.probe(all[c].cube, distance, next) ? distance : DEPTH + 1;
+            assert(table.lowerBound(all[c].cube, table.slotOf(all[c].cube)) == bound);
+            expected += bound <= budget;
+        }
+        assert(k == expected);
+        for (int c = 0; c < k; ++c) {
+            assert(kept[c].estimate <= budget && (c == 0 || kept[c - 1].estimate <= kept[c].estimate));
+            RubiksCube child = nodes[i];
+            child.move(kept[c].move);
+            assert(child == kept[c].cube && table.probe(child, distance, next) && distance == kept[c].estimate);
+        }
+    }
+
+    // TEST: the lockstep lookup finds exactly the stored cubes among eight at a time
+    for (int i = 0; i + 8 <= 800; i += 8) {
+        uint32_t faces[6 * 8];
+        size_t slots[8];
+        uint32_t stored = 0;
+        for (int lane = 0; lane < 8; ++lane) {
+            RubiksCube child = nodes[i + lane];
+            child.move(availableMoves[lane % 6]);
+            for (int f = 0; f < 6; ++f) faces[f * 8 + lane] = child.faces()[f];
+            slots[lane] = table.slotOf(child);
+            stored |= uint32_t(table.probe(child, distance, next)) << lane;
+        }
+        uint32_t lanes = rand() & 0xFF;
+        [[maybe_unused]] uint32_t found = table.findLanes(faces, 8, slots, lanes);
+        assert(found == (stored & lanes) && "Lockstep lookup disagrees with probe()");
+    }
+
+    // Per node: one child at a time against all children prefetched together
+    int serialKept = 0, pipelinedKept = 0;
+    startTime = CycleTimer::currentSeconds();
+    for (const RubiksCube& node : nodes) {
+        for (auto m : availableMoves) {
+            RubiksCube child = node;
+            child.move(m);
+            serialKept += table.probe(child, distance, next) && distance <= DEPTH;
+        }
+    }
+    double serialTime = CycleTimer::currentSeconds() - startTime;
+
+    startTime = CycleTimer::currentSeconds();
+    for (const RubiksCube& node : nodes) {
+        ChildNode children[MAX_CHILDREN];
+        pipelinedKept += expandNode(node, U1, 0, table, DEPTH, children);
+    }
+    double pipelinedTime = CycleTimer::currentSeconds() - startTime;
+
+    assert(serialKept == pipelinedKept);
+    cout << "Serial probes: " << 1e9 * serialTime / NUM_NODES << " ns/node, pipelined: "
+         << 1e9 * pipelinedTime / NUM_NODES << " ns/node" << endl;
+
+    // TEST: lockstep batch search solves every cube with the same solution lengths as one-at-a-time search
+    printf(">>>>>>>> Lockstep Batch Search\n");
+    const int NUM_CUBES = 64;
+    vector<RubiksCube> cubes(NUM_CUBES);
+    for (auto& cube : cubes) {
+        for (int j = 0; j < 4; ++j) cube.move(availableMoves[rand() % 6]);
+    }
+
+    PerfCounters counters;
+    SearchStats singleStats, batchStats;
+    vector<vector<MoveType>> single(NUM_CUBES);
+    counters.start();
+    [[maybe_unused]] int singleSolved = 0;
+    for (int i = 0; i < NUM_CUBES; ++i) singleSolved += solveCube(cubes[i], table, 14, single[i], &singleStats);
+    PerfSample singleSample = counters.stop();
+    double singleTime = singleSample.seconds;
+
+    vector<vector<MoveType>> batched;
+    vector<bool> solved;
+    counters.start();
+    [[maybe_unused]] int batchSolved = solveCubeBatch(cubes, table, 14, batched, solved, &batchStats);
+    PerfSample batchSample = counters.stop();
+    double batchTime = batchSample.seconds;
+
+    assert(singleSolved == NUM_CUBES && batchSolved == NUM_CUBES);
+    for (int i = 0; i < NUM_CUBES; ++i) {
+        assert(solved[i] && batched[i].size() == single[i].size());
+        RubiksCube cube = cubes[i];
+        for (auto m : batched[i]) cube.move(m);
+        assert(cube.isSolved());
+    }
+    cout << "One at a time: " << NUM_CUBES / singleTime << " cubes/s, lockstep: " << NUM_CUBES / batchTime
+         << " cubes/s" << endl;
+    cout << "One at a time per node: " << singleSample.report(singleStats.nodesExpanded, "node") << endl;
+    cout << "Lockstep per node: " << batchSample.report(batchStats.nodesExpanded, "node") << endl;
+
+    // TEST: cubes that can't be solved within the depth limit are reported and don't block the rest
+    RubiksCube deep;
+    deep.scramble();
+    cubes = {deep, SOLVED_CUBE, cubes[0]};
+    batchSolved = solveCubeBatch(cubes, table, 10, batched, solved);
+    assert(batchSolved == 1 + (single[0].size() <= 10));
+    assert(solved[1] && batched[1].empty());
+
+    return 0;
+}
@@ -0,0 +1,149 @@
+#include <cassert>
+#include <iostream>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "cycle_timer.h"
+#include "frontier_pool.h"
+#include "rubiks_cube.h"
+
+using namespace std;
+
+typedef unordered_set<RubiksCube, RubiksCubeHash, equal_to<RubiksCube>, PoolAllocator<RubiksCube>> PooledCubeSet;
+
+// Breadth-first levels from solved (with duplicates across levels), returning the size of the last level
+static size_t bufferLevels(ChunkPool& pool, int depth)
+{
+    FrontierBuffer frontier(pool), next(pool);
+    frontier.push_back(SOLVED_CUBE);
+    for (int d = 0; d < depth; ++d) {
+        frontier.forEach([&](const RubiksCube& state) {
+            for (auto m : availableMoves) {
+                RubiksCube child = state;
+                child.move(m);
+                next.push_back(child);
+            }
+        });
+        frontier.swap(next);
+        next.clear();
+    }
+    return frontier.size();
+}
+
+static size_t vectorLevels(int depth)
+{
+    vector<RubiksCube> frontier = {SOLVED_CUBE};
+    for (int d = 0; d < depth; ++d) {
+        vector<RubiksCube> next;
+        for (const RubiksCube& state : frontier) {
+            for (auto m : availableMoves) {
+                RubiksCube child = state;
+                child.move(m);
+                next.push_back(child);
+            }
+        }
+        frontier.swap(next);
+    }
+    return frontier.size();
+}
+
+int main(int argc, char **argv) {
+    // TEST: buffers keep states in order across chunk boundaries
+    printf(">>>>>>>> Frontier Buffer\n");
+    ChunkPool pool;
+    FrontierBuffer buffer(pool);
+    assert(buffer.empty() && buffer.numChunks() == 0);
+
+    const size_t NUM_STATES = 3 * CUBES_PER_CHUNK + 17;
+    vector<RubiksCube> expected;
+    RubiksCube cube;
+    for (size_t i = 0; i < NUM_STATES; ++i) {
+        cube.move(availableMoves[i % 5]);
+        buffer.push_back(cube);
+        expected.push_back(cube);
+    }
+    assert(buffer.size() == NUM_STATES && buffer.numChunks() == 4 && buffer.chunkSize(3) == 17);
+
+    [[maybe_unused]] size_t visited = 0;
+    buffer.forEach([&](const RubiksCube& state) {
+        assert(state == expected[visited]);
+        ++visited;
+    });
+    assert(visited == NUM_STATES);
+    for (size_t c = 0; c < buffer.numChunks(); ++c) {
+        [[maybe_unused]] const RubiksCube* states = buffer.chunk(c);
+        for (size_t j = 0; j < buffer.chunkSize(c); ++j) assert(states[j] == expected[c * CUBES_PER_CHUNK + j]);
+    }
+
+    // TEST: cleared chunks are reused rather than allocated again
+    buffer.clear();
+    assert(buffer.empty() && pool.allocated() == 4 && pool.available() == 4);
+    for (size_t i = 0; i < NUM_STATES; ++i) buffer.push_back(expected[i]);
+    assert(pool.allocated() == 4 && pool.available() == 0);
+
+    FrontierBuffer other(pool);
+    other.push_back(SOLVED_CUBE);
+    other.swap(buffer);
+    assert(other.size() == NUM_STATES && buffer.size() == 1 && pool.allocated() == 5);
+
+    // TEST: once the pool holds the peak working set, repeating the search allocates nothing
+    printf(">>>>>>>> Steady State Levels\n");
+    ChunkPool levelPool;
+    [[maybe_unused]] size_t levelSize = bufferLevels(levelPool, 6);
+    assert(levelSize == vectorLevels(6));
+    [[maybe_unused]] size_t peakChunks = levelPool.allocated();
+    for (int run = 0; run < 3; ++run) bufferLevels(levelPool, 6);
+    assert(levelPool.allocated() == peakChunks && levelPool.available() == peakChunks);
+
+    const int NUM_RUNS = 5;
+    double startTime = CycleTimer::currentSeconds();
+    for (int run = 0; run < NUM_RUNS; ++run) vectorLevels(7);
+    double vectorTime = CycleTimer::currentSeconds() - startTime;
+
+    startTime = CycleTimer::currentSeconds();
+    for (int run = 0; run < NUM_RUNS; ++run) bufferLevels(levelPool, 7);
+    double bufferTime = CycleTimer::currentSeconds() - startTime;
+
+    cout << "vector levels: " << 1e3 * vectorTime / NUM_RUNS << " ms, pooled levels: " << 1e3 * bufferTime / NUM_RUNS
+         << " ms, " << levelPool.allocated() << " chunks" << endl;
+
+    // TEST: each thread gets its own pool
+    [[maybe_unused]] ChunkPool* mainPool = &ChunkPool::local();
+    assert(mainPool == &ChunkPool::local());
+    thread worker([&]() {
+        assert(&ChunkPool::local() != mainPool);
+        FrontierBuffer local;
+        local.push_back(SOLVED_CUBE);
+        assert(ChunkPool::local().allocated() == 1);
+    });
+    worker.join();
+
+    // TEST: pooled containers hold the same contents and recycle erased nodes
+    printf(">>>>>>>> Pool Allocator\n");
+    PooledCubeSet pooled;
+    unordered_set<RubiksCube, RubiksCubeHash> plain;
+    for (const RubiksCube& state : expected) {
+        [[maybe_unused]] bool inserted = pooled.insert(state).second;
+        [[maybe_unused]] bool expectedInsert = plain.insert(state).second;
+        assert(inserted == expectedInsert);
+    }
+    assert(pooled.size() == plain.size());
+    for ([[maybe_unused]] const RubiksCube& state : plain) assert(pooled.count(state));
+
+    [[maybe_unused]] size_t slabs = pooled.get_allocator().arena->slabCount();
+    for (int run = 0; run < 3; ++run) {
+        pooled.clear();
+        for (const RubiksCube& state : expected) pooled.insert(state);
+    }
+    assert(pooled.get_allocator().arena->slabCount() == slabs);
+
+    unordered_map<RubiksCube, uint8_t, RubiksCubeHash, equal_to<RubiksCube>,
+                  PoolAllocator<pair<const RubiksCube, uint8_t>>>
+        distances;
+    distances[SOLVED_CUBE] = 0;
+    assert(distances.at(SOLVED_CUBE) == 0 && distances.count(expected[0]) == 0);
+
+    return 0;
+}
@@ -0,0 +1,118 @@
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+#include "cycle_timer.h"
+#include "endgame_table.h"
+#include "numa_topology.h"
+#include "perf_counters.h"
+#include "rubiks_cube.h"
+#include "solver.h"
+
+using namespace std;
+
+int main(int argc, char **argv) {
+    srand(time(0));
+
+    // TEST: topology detection always reports at least one node with CPUs
+    printf(">>>>>>>> NUMA Topology\n");
+    NumaTopology topology = NumaTopology::detect();
+    cout << topology.describe() << endl;
+    assert(topology.numNodes() >= 1 && topology.numCpus() >= 1);
+    for (int node = 0; node < topology.numNodes(); ++node) {
+        for ([[maybe_unused]] int cpu : topology.nodes()[node].cpus) assert(topology.nodeOfCpu(cpu) == node);
+    }
+
+#if defined(__linux__)
+    // TEST: only CPUs this process may run on are handed out, whichever way the topology was found
+    cpu_set_t allowed;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0) {
+        for (auto& node : topology.nodes()) {
+            for ([[maybe_unused]] int cpu : node.cpus) {
+                assert(CPU_ISSET(cpu, &allowed) && "Topology lists a cpu outside our affinity");
+            }
+        }
+    }
+#endif
+
+    // TEST: worker CPUs cover every node before doubling up on any of them
+    vector<int> cpus = topology.workerCpus(2 * topology.numCpus());
+    assert((int)cpus.size() == 2 * topology.numCpus());
+    for (int i = 0; i < topology.numNodes(); ++i) assert(topology.nodeOfCpu(cpus[i]) == i);
+
+    // TEST: both placements hold an exact copy of the source
+    printf(">>>>>>>> NUMA Placement\n");
+    vector<char> source(5 * 1024 * 1024 + 123);
+    for (size_t i = 0; i < source.size(); ++i) source[i] = rand();
+    for (auto placement : {NUMA_FIRST_TOUCH, NUMA_REPLICATE}) {
+        unique_ptr<NumaReplicas> replicas = NumaReplicas::create(topology, source.data(), source.size(), placement);
+        assert(replicas && replicas->placed());
+        for (int node = 0; node < topology.numNodes(); ++node) {
+            assert(memcmp(replicas->forNode(node), source.data(), source.size()) == 0);
+        }
+        assert(memcmp(replicas->local(), source.data(), source.size()) == 0);
+    }
+
+    // TEST: pinned workers solve with their node-local endgame table
+    printf(">>>>>>>> Pinned Workers\n");
+    EndgameTable table(6);
+    unique_ptr<NodeLocalTable<EndgameTable>> localTables =
+        NodeLocalTable<EndgameTable>::create(table, topology, NUMA_REPLICATE);
+    assert(localTables && localTables->placed());
+
+    const int NUM_CUBES = 32;
+    vector<RubiksCube> cubes(NUM_CUBES);
+    for (auto& cube : cubes) {
+        for (int j = 0; j < 3; ++j) cube.move(availableMoves[rand() % 6]);
+    }
+
+    vector<vector<MoveType>> solutions(NUM_CUBES);
+    vector<thread> workers;
+    cpus = topology.workerCpus(4);
+    vector<PerfSample> samples(cpus.size());
+    vector<SearchStats> workerStats(cpus.size());
+    vector<int> workerSolved(cpus.size()), workerPinned(cpus.size());
+    double startTime = CycleTimer::currentSeconds();
+    for (int t = 0; t < (int)cpus.size(); ++t) {
+        workers.emplace_back([&, t]() {
+            workerPinned[t] = pinThreadToCpu(cpus[t]);
+            const EndgameTable& local = localTables->local();
+            assert(local.size() == table.size());
+
+            // Counters only see the thread that opened them, so each worker measures itself
+            PerfCounters counters;
+            counters.start();
+            for (int i = t; i < NUM_CUBES; i += cpus.size()) {
+                workerSolved[t] += solveCube(cubes[i], local, 12, solutions[i], &workerStats[t]);
+            }
+            samples[t] = counters.stop();
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    double duration = CycleTimer::currentSeconds() - startTime;
+
+    int totalSolved = 0;
+    for (int t = 0; t < (int)cpus.size(); ++t) {
+        assert(workerPinned[t] && "Worker could not be pinned to its cpu");
+        totalSolved += workerSolved[t];
+    }
+    assert(totalSolved == NUM_CUBES);
+    for (int i = 0; i < NUM_CUBES; ++i) {
+        RubiksCube cube = cubes[i];
+        for (auto m : solutions[i]) cube.move(m);
+        assert(cube.isSolved());
+    }
+    cout << "Solved " << NUM_CUBES << " cubes on " << cpus.size() << " pinned workers in " << 1e3 * duration << " ms"
+         << endl;
+    for (int t = 0; t < (int)cpus.size(); ++t) {
+        cout << "Worker " << t << " on cpu " << cpus[t] << ": "
+             << samples[t].report(workerStats[t].nodesExpanded, "node") << endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,50 @@
+#include <cassert>
+#include <iostream>
+
+#include "perf_counters.h"
+#include "rubiks_cube.h"
+
+using namespace std;
+
+int main(int argc, char **argv) {
+    // TEST: counters open or are skipped cleanly, depending on what the kernel allows
+    printf(">>>>>>>> Perf Counters\n");
+    PerfCounters counters;
+    for (int i = 0; i < NUM_PERF_COUNTERS; ++i) {
+        PerfCounterType type = PerfCounterType(i);
+        const char* state = counters.grouped(type) ? "grouped" : counters.available(type) ? "standalone" : "unavailable";
+        cout << perfCounterNames[i] << ": " << state << endl;
+        assert(!counters.grouped(type) || counters.available(type));
+    }
+
+    // TEST: a measured region reports time, and counts that grow with the amount of work
+    printf(">>>>>>>> Perf Sample\n");
+    const long long NUM_MOVES = 1000000;
+    RubiksCube cube;
+
+    counters.start();
+    for (int i = 0; i < NUM_MOVES; ++i) cube.move(availableMoves[i % 6]);
+    PerfSample small = counters.stop();
+
+    counters.start();
+    for (int i = 0; i < 10 * NUM_MOVES; ++i) cube.move(availableMoves[i % 6]);
+    PerfSample large = counters.stop();
+
+    assert(small.seconds > 0 && large.seconds > 0);
+    for (int i = 0; i < NUM_PERF_COUNTERS; ++i) {
+        if (!counters.available(PerfCounterType(i))) assert(!small.valid[i] && small.values[i] == 0);
+    }
+    // Grouped counters are read together, so they are valid or invalid together
+    for (int i = 0; i < NUM_PERF_COUNTERS; ++i) {
+        if (counters.grouped(PerfCounterType(i))) assert(large.valid[i] == large.valid[PERF_CYCLES]);
+    }
+    if (small.valid[PERF_INSTRUCTIONS] && large.valid[PERF_INSTRUCTIONS]) {
+        assert(large.values[PERF_INSTRUCTIONS] > small.values[PERF_INSTRUCTIONS]);
+    }
+    cout << "Per move: " << large.report(10 * NUM_MOVES, "move") << endl;
+
+    // TEST: reports don't divide by zero
+    assert(!small.report(0, "node").empty());
+
+    return 0;
+}
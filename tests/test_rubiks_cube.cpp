@@ -3,6 +3,7 @@
 
 #include "rubiks_cube.h"
 #include "cycle_timer.h"
+#include "perf_counters.h"
 
 using namespace std;
 
@@ -25,9 +26,39 @@ int main(int argc, char **argv) {
         assert(cube == SOLVED_CUBE && "Cube is not re-solved after cyclic 4 moves");
     }
 
+    // TEST: move sequences have the orders they have on a real cube; a turn that moves the wrong stickers changes them
+    printf(">>>>>>>> Cube Move Orders\n");
+    for (auto a : availableMoves) {
+        for (auto b : availableMoves) {
+            if (a >> 1 == b >> 1) continue;
+
+            // (a b) has order 105 and (a b a' b') order 6 for any two adjacent faces
+            cube = RubiksCube();
+            int order = 0;
+            do {
+                cube.move(a);
+                cube.move(b);
+                ++order;
+            } while (!cube.isSolved());
+            assert(order == 105 && "Wrong order of two adjacent face turns");
+
+            order = 0;
+            do {
+                cube.move(a);
+                cube.move(b);
+                for (int i = 0; i < 3; ++i) cube.move(a);
+                for (int i = 0; i < 3; ++i) cube.move(b);
+                ++order;
+            } while (!cube.isSolved());
+            assert(order == 6 && "Wrong order of a commutator of adjacent face turns");
+        }
+    }
+
     // TEST: time how long executing moves takes
     printf(">>>>>>>> Cube Rotations Timing\n");
     const long long NUM_MOVES = 10000000;
+    PerfCounters counters;
+    counters.start();
     double startTime = CycleTimer::currentSeconds();
 
     for (int i = 0; i < NUM_MOVES; ++i) {
@@ -36,9 +67,11 @@ int main(int argc, char **argv) {
 
     double endTime = CycleTimer::currentSeconds();
     double duration = endTime - startTime;
+    PerfSample sample = counters.stop();
 
     cout << "Time to execute " << NUM_MOVES << " moves: " << duration << " s" << endl;
     cout << "Average time per move " << 1e9 * duration / (6 * NUM_MOVES) << " ns" << endl;
+    cout << "Per move: " << sample.report(6 * NUM_MOVES, "move") << endl;
     
     // TEST: scramble the cube and make sure the centers dont move
     printf(">>>>>>>> Cube Scramble\n");
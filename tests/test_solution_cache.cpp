@@ -0,0 +1,179 @@
+#include <cassert>
+#include <cstdio>
+#include <iostream>
+#include <thread>
+
+#include "cube_symmetry.h"
+#include "cycle_timer.h"
+#include "rubiks_cube.h"
+#include "solution_cache.h"
+
+using namespace std;
+
+static vector<MoveType> randomMoves(int length)
+{
+    vector<MoveType> moves;
+    for (int i = 0; i < length; ++i) moves.push_back(availableMoves[rand() % 6]);
+    return moves;
+}
+
+static RubiksCube applyMoves(RubiksCube cube, const vector<MoveType>& moves)
+{
+    for (auto m : moves) cube.move(m);
+    return cube;
+}
+
+int main(int argc, char **argv) {
+    srand(time(0));
+    const CubeSymmetry* symmetries = cubeSymmetries();
+
+    // TEST: symmetries commute with moves through moveMap
+    printf(">>>>>>>> Cube Symmetries\n");
+    for (int k = 0; k < NUM_CUBE_SYMMETRIES; ++k) {
+        RubiksCube cube = applyMoves(RubiksCube(), randomMoves(20));
+        assert(applySymmetry(SOLVED_CUBE, symmetries[k]) == SOLVED_CUBE);
+
+        for (auto m : availableMoves) {
+            RubiksCube moved = cube;
+            moved.move(m);
+            RubiksCube image = applySymmetry(cube, symmetries[k]);
+            image.move(symmetries[k].moveMap[m]);
+            assert(applySymmetry(moved, symmetries[k]) == image && "Symmetry does not commute with moves");
+        }
+    }
+
+    // TEST: inverting a cube undoes its scramble
+    printf(">>>>>>>> Cube Inversion\n");
+    for (int i = 0; i < 100; ++i) {
+        vector<MoveType> scramble = randomMoves(25);
+        [[maybe_unused]] RubiksCube cube = applyMoves(RubiksCube(), scramble);
+        assert(invertCube(cube) == applyMoves(RubiksCube(), invertMoves(scramble)));
+        assert(invertCube(invertCube(cube)) == cube);
+        assert(applyMoves(cube, invertMoves(scramble)).isSolved());
+    }
+
+    // TEST: a cached solution answers rotated and inverted variants of the state
+    printf(">>>>>>>> Symmetric Cache Hits\n");
+    SolutionCache cache(1 << 20);
+    vector<RubiksCube> cached;
+    for (int i = 0; i < 50; ++i) {
+        vector<MoveType> scramble = randomMoves(20);
+        RubiksCube cube = applyMoves(RubiksCube(), scramble);
+        cache.insert(cube, invertMoves(scramble));
+
+        vector<MoveType> solution;
+        [[maybe_unused]] bool hit = cache.lookup(cube, solution);
+        assert(hit && applyMoves(cube, solution).isSolved());
+
+        RubiksCube rotated = applySymmetry(cube, symmetries[1 + rand() % (NUM_CUBE_SYMMETRIES - 1)]);
+        hit = cache.lookup(rotated, solution);
+        assert(hit && applyMoves(rotated, solution).isSolved());
+
+        RubiksCube inverted = invertCube(cube);
+        hit = cache.lookup(inverted, solution);
+        assert(hit && applyMoves(inverted, solution).isSolved());
+        cached.push_back(cube);
+    }
+    SolutionCacheStats stats = cache.stats();
+    assert(stats.hits == 150 && stats.misses == 0);
+
+    RubiksCube unseen = applyMoves(RubiksCube(), randomMoves(30));
+    vector<MoveType> solution;
+    [[maybe_unused]] bool hit = cache.lookup(unseen, solution);
+    assert(!hit && cache.stats().misses == 1);
+
+    // TEST: snapshot round trip answers the same states with working solutions
+    printf(">>>>>>>> Cache Snapshot\n");
+    const char* path = "solution_cache_snapshot.bin";
+    [[maybe_unused]] bool ok = cache.saveSnapshot(path);
+    assert(ok);
+    SolutionCache restored(1 << 20);
+    ok = restored.loadSnapshot(path);
+    assert(ok && restored.stats().entries == cache.stats().entries);
+    for (const RubiksCube& cube : cached) {
+        hit = restored.lookup(cube, solution);
+        assert(hit && applyMoves(cube, solution).isSolved());
+    }
+
+    // TEST: corrupt or truncated snapshots are rejected without loading anything
+    FILE* fp = fopen(path, "rb");
+    vector<uint8_t> bytes(1 << 20);
+    bytes.resize(fread(bytes.data(), 1, bytes.size(), fp));
+    fclose(fp);
+
+    // Header, then the first record's faces and length; the byte after is its first move
+    const size_t FIRST_MOVE = 2 * sizeof(uint32_t) + 6 * sizeof(uint32_t) + 1;
+    auto loadsAfter = [&](vector<uint8_t> corrupt) {
+        fp = fopen(path, "wb");
+        fwrite(corrupt.data(), 1, corrupt.size(), fp);
+        fclose(fp);
+        SolutionCache fresh(1 << 20);
+        bool loaded = fresh.loadSnapshot(path);
+        assert(loaded || fresh.stats().entries == 0);
+        return loaded;
+    };
+    assert(bytes.size() > FIRST_MOVE && bytes[FIRST_MOVE - 1] > 0);
+    vector<uint8_t> corrupt = bytes;
+    corrupt[FIRST_MOVE] = 6;
+    ok = loadsAfter(corrupt);
+    assert(!ok && "Move out of range was loaded");
+
+    corrupt = bytes;
+    corrupt[2 * sizeof(uint32_t)] ^= 0x7;  // low byte of face 0 holds no facelets
+    ok = loadsAfter(corrupt);
+    assert(!ok && "Face with spare bits set was loaded");
+
+    corrupt = bytes;
+    corrupt[2 * sizeof(uint32_t) + 2] ^= 0x0E;  // bits 17-19 of face 0, its center facelet
+    ok = loadsAfter(corrupt);
+    assert(!ok && "Face with a moved center was loaded");
+
+    corrupt = bytes;
+    corrupt.resize(bytes.size() - 1);
+    ok = loadsAfter(corrupt);
+    assert(!ok && "Truncated snapshot was loaded");
+
+    corrupt = bytes;
+    corrupt.resize(FIRST_MOVE - 1 - sizeof(uint32_t));  // first record cut off inside its faces
+    ok = loadsAfter(corrupt);
+    assert(!ok && "Snapshot cut off inside a record's faces was loaded");
+
+    ok = loadsAfter(bytes);
+    assert(ok);
+    remove(path);
+
+    // TEST: memory bound holds under concurrent inserts and lookups
+    printf(">>>>>>>> Concurrent Eviction\n");
+    const size_t MAX_BYTES = 16 * 1024;
+    SolutionCache small(MAX_BYTES, 4);
+    vector<thread> workers;
+    double startTime = CycleTimer::currentSeconds();
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([&small, t]() {
+            unsigned int seed = t;
+            for (int i = 0; i < 5000; ++i) {
+                // Short scrambles so queries repeat and hit
+                vector<MoveType> scramble;
+                for (int j = 0; j < 6; ++j) scramble.push_back(availableMoves[rand_r(&seed) % 6]);
+                RubiksCube cube = applyMoves(RubiksCube(), scramble);
+
+                vector<MoveType> solution;
+                if (small.lookup(cube, solution)) {
+                    assert(applyMoves(cube, solution).isSolved());
+                } else {
+                    small.insert(cube, invertMoves(scramble));
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    double duration = CycleTimer::currentSeconds() - startTime;
+
+    stats = small.stats();
+    cout << "hits " << stats.hits << ", misses " << stats.misses << ", evictions " << stats.evictions << ", entries "
+         << stats.entries << endl;
+    assert(stats.bytes <= MAX_BYTES && stats.evictions > 0);
+    cout << "Average time per query " << 1e6 * duration / 20000 << " us" << endl;
+
+    return 0;
+}